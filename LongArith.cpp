@@ -9,13 +9,31 @@ https://github.com/AngelicosPhosphoros/LongArithmeticsCPP/
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
-#include <deque>
 #include <tuple>
 #include <cstring>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <cmath>
+#include <new>
 
 #if defined(_MSC_VER)
 #include <BaseTsd.h>
+#include <io.h>
 typedef SSIZE_T ssize_t;
+#else
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 
@@ -105,32 +123,194 @@ static size_t get_digit_count(digit_t val)
     return res;
 }
 
-// Checks that string is correct integer
-static bool check_string(const std::string& s)
+//****************** THREADING UTILS **********************
+
+// Minimal count of digits which is worth own thread
+constexpr size_t ParallelMinDigits = 1 << 14;
+
+// Minimal count of digit products in multiplication which is worth own thread
+constexpr size_t ParallelMinMultProducts = 1 << 20;
+
+// How many threads should work on work_digits digits
+static size_t threads_for(const LongArith::ExecutionPolicy& policy, const size_t work_digits)
 {
-    using namespace std;
-    //constexpr char digits[] = "0123456789";
-    if (s.empty())
-        return false;
-    auto iterator = s.cbegin();
-    // Check symbols
-    if (s[0] == '+' || s[0] == '-')
+    return std::max<size_t>(1, std::min(policy.thread_count(), work_digits / ParallelMinDigits));
+}
+
+// Joins every started thread when scope is left, also by exception,
+// so destructor of std::thread never sees joinable thread
+class thread_join_guard
+{
+public:
+    explicit thread_join_guard(std::vector<std::thread>& guarded_workers) noexcept : workers(guarded_workers) {}
+    ~thread_join_guard()
     {
-        ++iterator;
-        if (s.length() == 1)
-            return false;
+        for (auto& worker : workers)
+        {
+            if (worker.joinable())
+                worker.join();
+        }
+    }
+    thread_join_guard(const thread_join_guard&) = delete;
+    thread_join_guard& operator=(const thread_join_guard&) = delete;
+
+private:
+    std::vector<std::thread>& workers;
+};
+
+// Splits [0, count) to equal parts and runs body(begin, end) for them in several threads
+// Caller thread takes first part. If body throws in some parts, all threads are finished
+// and then exception of first such part is rethrown
+template<typename Body>
+static void parallel_for(const size_t count, const size_t threads, const Body& body)
+{
+    const size_t parts = std::min(threads, count);
+    if (parts <= 1)
+    {
+        body(size_t(0), count);
+        return;
     }
-    for (; iterator != s.cend(); ++iterator)
+    const size_t part_size = (count + parts - 1) / parts;
+    std::vector<std::exception_ptr> errors(parts);
+    const auto run_part = [&body, &errors](const size_t part, const size_t begin, const size_t end) noexcept
     {
-        //if (!binary_search(begin(digits), end(digits), *iterator))
-        if (*iterator<'0' || *iterator>'9')
+        try
         {
-            return false;
+            body(begin, end);
+        }
+        catch (...)
+        {
+            errors[part] = std::current_exception();
         }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(parts - 1);
+    {
+        thread_join_guard guard(workers);
+        size_t part = 1;
+        for (size_t begin = part_size; begin < count; begin += part_size, ++part)
+        {
+            const size_t end = std::min(count, begin + part_size);
+            workers.emplace_back([&run_part, part, begin, end]() { run_part(part, begin, end); });
+        }
+        run_part(0, size_t(0), part_size);
+    }
+    for (const auto& error : errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+// Decimal representation of every number from 0 to 99, used to print two digits at once
+static const char DigitPairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// Writes exactly DigitStringLength decimal characters of value with leading zeros
+static inline void write_digit_padded(digit_t value, char* out)
+{
+    // DigitStringLength is odd, so most significant character is left after pairs
+    for (size_t i = DigitStringLength; i > 1; i -= 2)
+    {
+        const char* pair = DigitPairs + (value % 100) * 2;
+        value /= 100;
+        out[i - 2] = pair[0];
+        out[i - 1] = pair[1];
+    }
+    out[0] = static_cast<char>('0' + value);
+}
+
+// Writes decimal characters of value without leading zeros
+// \param length must be get_digit_count(value)
+static inline void write_digit(digit_t value, char* out, const size_t length)
+{
+    char* position = out + length;
+    while (value >= 100)
+    {
+        const char* pair = DigitPairs + (value % 100) * 2;
+        value /= 100;
+        position -= 2;
+        position[0] = pair[0];
+        position[1] = pair[1];
+    }
+    if (value >= 10)
+    {
+        position -= 2;
+        position[0] = DigitPairs[value * 2];
+        position[1] = DigitPairs[value * 2 + 1];
+    }
+    else
+    {
+        *--position = static_cast<char>('0' + value);
+    }
+    LA_ASSERT(position == out);
+}
+
+// SWAR parsing of decimal strings
+// 8 characters are loaded to one 64-bit word, first character in lowest byte, so it needs little-endian target.
+// Other targets parse characters one by one
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define LONGARITH_SWAR_PARSE
+#endif
+
+#if defined(LONGARITH_SWAR_PARSE)
+static inline uint64_t load_8_chars(const char* p)
+{
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    return chunk;
+}
+
+// true if all 8 characters of chunk are decimal digits
+static inline bool swar_is_8_digits(const uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// Converts 8 decimal characters to number with 3 multiplications
+static inline digit_t swar_parse_8_digits(uint64_t chunk)
+{
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8); // pairs of digits
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+        + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<digit_t>(chunk);
+}
+#endif
+
+// Parses exactly DigitStringLength characters
+// \return false if any of them is not a digit
+static inline bool parse_digit_padded(const char* p, digit_t& value)
+{
+    static_assert(LongArith::DigitStringLength == 9, "One character and one SWAR word must be one digit");
+#if defined(LONGARITH_SWAR_PARSE)
+    const uint64_t chunk = load_8_chars(p + 1);
+    if (p[0] < '0' || p[0] > '9' || !swar_is_8_digits(chunk))
+        return false;
+    value = static_cast<digit_t>(p[0] - '0') * 100000000UL + swar_parse_8_digits(chunk);
+#else
+    digit_t result = 0;
+    for (size_t i = 0; i < LongArith::DigitStringLength; ++i)
+    {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+        result = result * 10 + static_cast<digit_t>(p[i] - '0');
     }
+    value = result;
+#endif
     return true;
 }
 
+// Vector that encodes zero
+static container_type zero_vector()
+{
+    container_type zero;
+    zero.push_back(0);
+    return zero;
+}
+
 // Remove all zeros at end except vect[0]
 static void clean_leading_zeros(container_type& vect)
 {
@@ -143,11 +323,23 @@ static void clean_leading_zeros(container_type& vect)
     }
 }
 
+// Thread local scratch buffers keep capacity between calls only up to this count of digits
+constexpr size_t ScratchMaxKeptDigits = 1 << 12;
+
+// Frees memory of scratch buffer if it is too big to be kept, so one operation on huge values doesn't pin memory in thread
+static void release_big_scratch(container_type& scratch)
+{
+    if (scratch.capacity() > ScratchMaxKeptDigits)
+        scratch = container_type();
+}
+
 //****************** ARRAY OPERATING UTILS **********************
 
 // Compares absolute values of encoded numbers in vectors
+// Works with any digit arrays that have size() and operator[], e.g. LongArithView
 // -1 if left>right, 1 if left<right, 0 otherwise
-static inline signed short compare_absolute_vectors(const container_type& left, const container_type& right)
+template<typename Left, typename Right>
+static inline signed short compare_absolute_vectors(const Left& left, const Right& right)
 {
     if (left.size() > right.size())
         return -1;
@@ -166,9 +358,11 @@ static inline signed short compare_absolute_vectors(const container_type& left,
 
 // Implementation of add_array
 // Assume original and addition is different
-static void unchecked_internal_add_array(container_type& original, const container_type& addition, const size_t shift)
+// Addition can be any digit array that has size() and operator[]
+template<typename Addition>
+static void unchecked_internal_add_array(container_type& original, const Addition& addition, const size_t shift)
 {
-    LA_ASSERT(&original != &addition);
+    LA_ASSERT(static_cast<const void*>(&original) != static_cast<const void*>(&addition));
     // when we work with addition, we keep in mind "virtual" digits
     const size_t addition_size = addition.size();
     if (addition_size + shift > (original.capacity() << 1))
@@ -243,8 +437,9 @@ inline static void add_array(container_type &original, const container_type &add
 
 // decrement bigger by less and store data in bigger
 // \param bigger is changing digits
-// \param less is value which decreased left
-static void substract_array(container_type &bigger, const container_type &less)
+// \param less is value which decreased left, any digit array that has size() and operator[]
+template<typename Less>
+static void substract_array(container_type &bigger, const Less &less)
 {
     LA_ASSERT(bigger.size() >= less.size());
     const size_t bigger_size = bigger.size(), less_size = less.size();
@@ -324,74 +519,129 @@ static void inline dec1_array(container_type &num)
 }
 
 
-// This is always increase absolute value of array
-// \param change must be positive
-static void increment_array(container_type &arr, compute_t change)
+// Splits native value into digits of DigitBase, least significant first
+// \return count of digits, at least one
+static size_t split_native(LongArith::native_uint_t value, digit_t (&digits)[LongArith::NativeDigitCount])
 {
-    LA_ASSERT(change >= 0);
-    switch (change)
+    size_t count = 0;
+    // Most values fit in 64 bits and division of them is much cheaper
+    while (value > std::numeric_limits<unsigned long long>::max())
     {
-    case 0: return;
-    case 1:
-        inc1_array(arr);
-        return;
-    default:
-        compute_t sum = change;
-        for (size_t index = 0, arr_size = arr.size(); sum && index < arr_size; index++)
-        {
-            sum += arr[index];
-            arr[index] = sum % DigitBase;
-            sum /= DigitBase;
-        }
-        while (sum)
-        {
-            arr.push_back(sum % DigitBase);
-            sum /= DigitBase;
-        }
+        digits[count++] = TO_DIGIT_T(value % DigitBase);
+        value /= DigitBase;
     }
+    unsigned long long short_value = static_cast<unsigned long long>(value);
+    do
+    {
+        digits[count++] = TO_DIGIT_T(short_value % DigitBase);
+        short_value /= DigitBase;
+    } while (short_value);
+    return count;
 }
-// This will decrease absolute value of array.
-// \param change must be lower than DigitBase squared
-// \return if arr>change return true else false (means change digit)
-static bool decrement_array(container_type &arr, digit_t change)
-{
-    LA_ASSERT(change >= 0);
-    LA_ASSERT(change < DigitBase*DigitBase);
 
-    compute_t current_val = (arr.size() > 1) ?
-        (arr[0] + arr[1] * DigitBase) : arr[0];
+// Increase absolute value of num by short array of digits
+static void add_digits(container_type &num, const digit_t* digits, const size_t count)
+{
+    const size_t old_size = num.size();
+    if (old_size < count)
+    {
+        num.resize(count);
+        std::fill(num.begin() + old_size, num.end(), 0);
+    }
+    compute_t sum = 0;
+    size_t index = 0;
+    for (; index < count; ++index)
+    {
+        sum += num[index];
+        sum += digits[index];
+        num[index] = sum % DigitBase;
+        sum /= DigitBase;
+    }
+    for (const size_t num_size = num.size(); sum && index < num_size; ++index)
+    {
+        sum += num[index];
+        num[index] = sum % DigitBase;
+        sum /= DigitBase;
+    }
+    if (sum)
+    {
+        num.push_back(TO_DIGIT_T(sum));
+    }
+}
 
-    if (change > current_val)
+// Decrease absolute value of num by short array of digits
+// If num is less than digits, num becomes digits - num
+// \return true if num was less than digits (sign must be changed)
+static bool substract_digits(container_type &num, const digit_t* digits, const size_t count)
+{
+    const size_t num_size = num.size();
+    signed short cmp = 0; // -1 if num>digits, 1 if num<digits
+    if (num_size != count)
+    {
+        cmp = (num_size > count) ? -1 : 1;
+    }
+    else
     {
-        // zero lower digits
-        for (size_t i = 0; i < std::min<size_t>(2, arr.size());++i)
+        for (size_t i = count; i && !cmp; --i)
         {
-            arr[i] = 0;
+            if (num[i - 1] != digits[i - 1])
+                cmp = (num[i - 1] > digits[i - 1]) ? -1 : 1;
         }
-        change -= TO_DIGIT_T(current_val);
+    }
 
-        if (arr.size() > 2)
+    compute_t to_del = 0;
+    if (cmp <= 0)
+    {
+        size_t index = 0;
+        for (; index < count; ++index)
         {
-            change -= 1;
-            dec1_array(arr);
-            arr[0] -= TO_DIGIT_T(change % DigitBase);
-            arr[1] -= TO_DIGIT_T(change / DigitBase);
-            return true;
+            to_del += digits[index];
+            if (to_del > num[index])
+            {
+                num[index] = TO_DIGIT_T(DigitBase - (to_del - num[index]));
+                to_del = 1;
+            }
+            else
+            {
+                num[index] = TO_DIGIT_T(num[index] - to_del);
+                to_del = 0;
+            }
         }
-        else // We changed sign
+        for (; to_del && index < num_size; ++index)
         {
-            increment_array(arr, change);
-            return false;
+            if (num[index])
+            {
+                --num[index];
+                to_del = 0;
+            }
+            else
+            {
+                num[index] = DigitBase - 1;
+            }
         }
     }
-    else
+    else // num is shorter so result fits into count digits
     {
-        const compute_t comp_result = current_val - change;
-        arr[0] = TO_DIGIT_T(comp_result % DigitBase);
-        if (arr.size() > 1)
-            arr[1] = TO_DIGIT_T(comp_result / DigitBase);
-        return false;
+        num.resize(count);
+        std::fill(num.begin() + num_size, num.end(), 0);
+        for (size_t index = 0; index < count; ++index)
+        {
+            to_del += num[index];
+            if (to_del > digits[index])
+            {
+                num[index] = TO_DIGIT_T(DigitBase - (to_del - digits[index]));
+                to_del = 1;
+            }
+            else
+            {
+                num[index] = TO_DIGIT_T(digits[index] - to_del);
+                to_del = 0;
+            }
+        }
     }
+    LA_ASSERT(!to_del);
+    clean_leading_zeros(num);
+    return cmp > 0;
 }
 
 //======= Mult
@@ -425,21 +675,341 @@ static void mult_small(container_type& big_number, const compute_t multiplicator
     }
 }
 
+// Multiplication of big value on short array of digits in place
+// Complexity O(n*count), memory O(1)
+static void mult_digits(container_type& big_number, const digit_t* digits, const size_t count)
+{
+    if (count == 1)
+    {
+        mult_small(big_number, digits[0]);
+        return;
+    }
+    const size_t big_number_size = big_number.size();
+    big_number.resize(big_number_size + count);
+    std::fill(big_number.begin() + big_number_size, big_number.end(), 0);
+    // Go from most significant digit so every digit is read before it is overwritten
+    for (size_t i1 = big_number_size; i1 > 0; --i1)
+    {
+        const size_t i = i1 - 1;
+        const compute_t current = big_number[i];
+        big_number[i] = 0;
+        if (!current)
+            continue;
+        compute_t trans_product = 0;
+        for (size_t j = 0; j < count; ++j)
+        {
+            trans_product += big_number[i + j] + current * digits[j];
+            big_number[i + j] = trans_product % DigitBase;
+            trans_product /= DigitBase;
+        }
+        for (size_t j = i + count; trans_product; ++j)
+        {
+            trans_product += big_number[j];
+            big_number[j] = trans_product % DigitBase;
+            trans_product /= DigitBase;
+        }
+    }
+    clean_leading_zeros(big_number);
+}
+
+// If bigger operand is at least this times longer than smaller, it is multiplied by chunks
+constexpr size_t UnbalancedMultRatio = 2;
+
+// Adds addition to target, both have same size
+// \return carry from most significant digit
+static digit_t add_digits_inplace(digit_t* target, const digit_t* addition, const size_t size)
+{
+    compute_t sum = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        sum += target[i];
+        sum += addition[i];
+        target[i] = sum % DigitBase;
+        sum /= DigitBase;
+    }
+    return TO_DIGIT_T(sum);
+}
+
+// Schoolbook multiplication of digit arrays
+// Complexity is O(a_size*b_size)
+// \param result must have a_size + b_size digits filled by zeros
+static void mult_basecase(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result)
+{
+    for (size_t i = 0; i < b_size; ++i)
+    {
+        const compute_t current = b[i];
+        if (!current)
+            continue;
+        digit_t* row = result + i;
+        compute_t trans_product = 0;
+        for (size_t j = 0; j < a_size; ++j)
+        {
+            trans_product += row[j] + current * a[j];
+            row[j] = trans_product % DigitBase;
+            trans_product /= DigitBase;
+        }
+        // This digit is not touched by previous rows
+        row[a_size] = TO_DIGIT_T(trans_product);
+    }
+}
+
+// Schoolbook multiplication which computes only low result_size digits of product
+// \param result must have result_size digits filled by zeros
+static void mult_low_basecase(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result, const size_t result_size)
+{
+    for (size_t i = 0, rows = std::min(b_size, result_size); i < rows; ++i)
+    {
+        const compute_t current = b[i];
+        if (!current)
+            continue;
+        digit_t* row = result + i;
+        const size_t row_size = std::min(a_size, result_size - i);
+        compute_t trans_product = 0;
+        for (size_t j = 0; j < row_size; ++j)
+        {
+            trans_product += row[j] + current * a[j];
+            row[j] = trans_product % DigitBase;
+            trans_product /= DigitBase;
+        }
+        // Carry out of low part is dropped
+        if (i + row_size < result_size)
+            row[row_size] = TO_DIGIT_T(trans_product);
+    }
+}
+
+// Schoolbook multiplication which computes only digits of product starting from first_column
+// Partial products of lower columns are skipped, so carry from them is lost
+// \param result must have a_size + b_size - first_column digits filled by zeros
+static void mult_high_basecase(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result, const size_t first_column)
+{
+    for (size_t i = 0; i < b_size; ++i)
+    {
+        const compute_t current = b[i];
+        if (!current)
+            continue;
+        const size_t first_j = (first_column > i) ? first_column - i : 0;
+        if (first_j >= a_size)
+            continue;
+        digit_t* row = result + i + first_j - first_column;
+        compute_t trans_product = 0;
+        for (size_t j = first_j; j < a_size; ++j)
+        {
+            trans_product += row[j - first_j] + current * a[j];
+            row[j - first_j] = trans_product % DigitBase;
+            trans_product /= DigitBase;
+        }
+        // This digit is not touched by previous rows
+        row[a_size - first_j] = TO_DIGIT_T(trans_product);
+    }
+}
+
+// Operands shorter than this are multiplied by schoolbook, it is faster than Karatsuba on short numbers
+constexpr size_t KaratsubaMinDigits = 32;
+
+// Sum of digit arrays, a_size >= b_size
+// \param result must have a_size + 1 digits, most significant one gets carry
+static void add_digits(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result)
+{
+    LA_ASSERT(a_size >= b_size);
+    compute_t sum = 0;
+    for (size_t i = 0; i < a_size; ++i)
+    {
+        sum += a[i];
+        if (i < b_size)
+            sum += b[i];
+        result[i] = sum % DigitBase;
+        sum /= DigitBase;
+    }
+    result[a_size] = TO_DIGIT_T(sum);
+}
+
+// Adds addition to target and propagates carry up to target_size, addition_size <= target_size
+// \return carry from most significant digit of target
+static digit_t add_digits_carry(digit_t* target, const size_t target_size, const digit_t* addition, const size_t addition_size)
+{
+    LA_ASSERT(addition_size <= target_size);
+    compute_t carry = add_digits_inplace(target, addition, addition_size);
+    for (size_t i = addition_size; carry && i < target_size; ++i)
+    {
+        carry += target[i];
+        target[i] = carry % DigitBase;
+        carry /= DigitBase;
+    }
+    return TO_DIGIT_T(carry);
+}
+
+// Substracts subtrahend from target and propagates borrow up to target_size, subtrahend_size <= target_size
+// \return borrow from most significant digit of target
+static digit_t sub_digits_inplace(digit_t* target, const size_t target_size, const digit_t* subtrahend, const size_t subtrahend_size)
+{
+    LA_ASSERT(subtrahend_size <= target_size);
+    compute_t borrow = 0;
+    for (size_t i = 0; i < target_size && (i < subtrahend_size || borrow); ++i)
+    {
+        compute_t difference = static_cast<compute_t>(target[i]) - borrow;
+        if (i < subtrahend_size)
+            difference -= subtrahend[i];
+        borrow = difference < 0;
+        target[i] = TO_DIGIT_T(difference + borrow * DigitBase);
+    }
+    return TO_DIGIT_T(borrow);
+}
+
+static void mult_balanced(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result);
+static void mult_unbalanced(const digit_t* big, const size_t big_size, const digit_t* small, const size_t small_size, digit_t* result);
+
+// Karatsuba multiplication: a = a1*B^h + a0, b = b1*B^h + b0, then
+// a*b = a1*b1*B^2h + ((a1 + a0)*(b1 + b0) - a1*b1 - a0*b0)*B^h + a0*b0, three half size products instead of four
+// Complexity is O(n^1.58), memory O(n)
+// \param result must have a_size + b_size digits filled by zeros
+static void mult_karatsuba(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result)
+{
+    LA_ASSERT(a_size >= b_size);
+    const size_t half = (a_size + 1) / 2;
+    LA_ASSERT(b_size > half);
+    const size_t a_high_size = a_size - half;
+    const size_t b_high_size = b_size - half;
+
+    // Products of halves go to own places of result, they don't overlap
+    mult_balanced(a, half, b, half, result);
+    mult_balanced(a + half, a_high_size, b + half, b_high_size, result + 2 * half);
+
+    // Sums of halves have half + 1 digits, their product has 2*half + 2 digits
+    const size_t sum_size = half + 1;
+    const size_t middle_size = 2 * sum_size;
+    container_type buffer(2 * sum_size + middle_size);
+    buffer.resize(2 * sum_size + middle_size);
+    digit_t* a_sum = buffer.begin();
+    digit_t* b_sum = a_sum + sum_size;
+    digit_t* middle = b_sum + sum_size;
+    add_digits(a, half, a + half, a_high_size, a_sum);
+    add_digits(b, half, b + half, b_high_size, b_sum);
+    std::fill(middle, middle + middle_size, 0);
+    mult_balanced(a_sum, sum_size, b_sum, sum_size, middle);
+
+    digit_t borrow = sub_digits_inplace(middle, middle_size, result, 2 * half);
+    borrow |= sub_digits_inplace(middle, middle_size, result + 2 * half, a_high_size + b_high_size);
+    LA_ASSERT(!borrow);
+    (void)borrow;
+
+    // Middle is a1*b0 + a0*b1, it fits in result after shift, so its digits outside of result are zeros
+    const size_t result_size = a_size + b_size;
+    size_t middle_used = std::min(middle_size, result_size - half);
+    LA_ASSERT(std::all_of(middle + middle_used, middle + middle_size, [](const digit_t digit) { return !digit; }));
+    while (middle_used && !middle[middle_used - 1])
+        --middle_used;
+    const digit_t carry = add_digits_carry(result + half, result_size - half, middle, middle_used);
+    LA_ASSERT(!carry);
+    (void)carry;
+}
+
+// Multiplication of digit arrays with close sizes by best algorithm we have
+// Short operands are multiplied by schoolbook, long ones by Karatsuba
+// \param result must have a_size + b_size digits filled by zeros
+static void mult_balanced(const digit_t* a, const size_t a_size, const digit_t* b, const size_t b_size, digit_t* result)
+{
+    if (a_size < b_size)
+    {
+        mult_balanced(b, b_size, a, a_size, result);
+        return;
+    }
+    if (b_size < KaratsubaMinDigits)
+        mult_basecase(a, a_size, b, b_size, result);
+    else if (b_size <= (a_size + 1) / 2)
+        // Karatsuba needs both operands longer than half
+        mult_unbalanced(a, a_size, b, b_size, result);
+    else
+        mult_karatsuba(a, a_size, b, b_size, result);
+}
+
+// Multiplication of digit arrays with very different sizes
+// Bigger one is split to chunks of small_size digits, every chunk is multiplied by balanced algorithm
+// and product is added to result with shift, so we never work with much more than 2*small_size digits at once
+// \param result must have big_size + small_size digits filled by zeros
+static void mult_unbalanced(const digit_t* big, const size_t big_size, const digit_t* small, const size_t small_size, digit_t* result)
+{
+    LA_ASSERT(big_size >= small_size);
+    container_type chunk_product(2 * small_size);
+    chunk_product.resize(2 * small_size);
+    for (size_t shift = 0; shift < big_size; shift += small_size)
+    {
+        const size_t chunk_size = std::min(small_size, big_size - shift);
+        const size_t product_size = chunk_size + small_size;
+        std::fill(chunk_product.begin(), chunk_product.begin() + product_size, 0);
+        mult_balanced(big + shift, chunk_size, small, small_size, &chunk_product[0]);
+        // Digits after overlap with previous chunk are still zero, so carry cannot leave product_size
+        const digit_t carry = add_digits_inplace(result + shift, &chunk_product[0], product_size);
+        LA_ASSERT(!carry);
+        (void)carry;
+    }
+}
+
+// Multiplication of digit arrays by balanced or unbalanced algorithm
+// \param result must have big_size + small_size digits filled by zeros
+static void mult_arrays(const digit_t* big, const size_t big_size, const digit_t* small, const size_t small_size, digit_t* result)
+{
+    LA_ASSERT(big_size >= small_size);
+    if (big_size >= small_size * UnbalancedMultRatio)
+        mult_unbalanced(big, big_size, small, small_size, result);
+    else
+        mult_balanced(big, big_size, small, small_size, result);
+}
+
+// Multiplication in several threads
+// Digits of smaller operand are split to blocks of rows, every thread multiplies bigger operand by own block
+// into own buffer. Blocks have equal work, so static split is balanced. Products are added to result
+// by calling thread, it takes O(threads*(big_size + small_size))
+// \param result must have big_size + small_size digits filled by zeros
+static void mult_parallel(const digit_t* big, const size_t big_size, const digit_t* small, const size_t small_size, digit_t* result, const size_t threads)
+{
+    const size_t parts = std::min(threads, small_size);
+    const size_t part_size = (small_size + parts - 1) / parts;
+    std::vector<container_type> products((small_size + part_size - 1) / part_size);
+    parallel_for(products.size(), products.size(), [&](const size_t begin, const size_t end) {
+        for (size_t part = begin; part < end; ++part)
+        {
+            const size_t shift = part * part_size;
+            const size_t rows = std::min(part_size, small_size - shift);
+            container_type& product = products[part];
+            product = container_type(big_size + rows);
+            product.resize(big_size + rows);
+            std::fill(product.begin(), product.end(), 0);
+            mult_arrays(big, big_size, small + shift, rows, product.begin());
+        }
+    });
+    for (size_t part = 0; part < products.size(); ++part)
+    {
+        // Result has only products of lower blocks, so carry cannot leave this product
+        const digit_t carry = add_digits_inplace(result + part * part_size, products[part].begin(), products[part].size());
+        LA_ASSERT(!carry);
+        (void)carry;
+    }
+}
+
 // Multiplication of two long numbers
-// Complexity is O(m1.size()*m2.size())
-static container_type mult_big(const container_type& m1, const container_type& m2)
+// Single digit operands are multiplied by mult_small, very different sizes by mult_unbalanced
+// Complexity is O(n^1.58) for close sizes and O(m*n^0.58) for sizes m > n
+// \param threads - if more than one, work is split by mult_parallel
+static container_type mult_big(const container_type& m1, const container_type& m2, const size_t threads = 1)
 {
-    container_type result(m1.size()+m2.size());
-    result.push_back(0);
     const container_type& bigger = (m1.size() > m2.size()) ? m1 : m2;
     const container_type& smaller = (m1.size() > m2.size()) ? m2 : m1;
-    container_type trans_product;
-    for (size_t i = 0, smaller_size = smaller.size(); i < smaller_size;i++)
+    if (smaller.size() == 1)
     {
-        trans_product = bigger;
-        mult_small(trans_product, smaller[i]);
-        add_array(result, trans_product, i);
+        container_type result(bigger);
+        mult_small(result, smaller[0]);
+        return result;
     }
+
+    const size_t result_size = m1.size() + m2.size();
+    container_type result(result_size);
+    result.resize(result_size);
+    std::fill(result.begin(), result.end(), 0);
+    if (threads > 1)
+        mult_parallel(bigger.begin(), bigger.size(), smaller.begin(), smaller.size(), result.begin(), threads);
+    else
+        mult_arrays(bigger.begin(), bigger.size(), smaller.begin(), smaller.size(), result.begin());
+    clean_leading_zeros(result);
     return result;
 }
 
@@ -447,10 +1017,11 @@ static container_type mult_big(const container_type& m1, const container_type& m
 
 // returns fraction in result & put remainder into dividend
 // Size of dividend_and_remainder must be bigger than divider only by one digit
-// Complexity: O(n^2) in mean, O(log(DigitBase)*n^2) in worst case
+// Complexity: O(n), digit is estimated by most significant digits and corrected few times
 // \param dividend_and_remainder must begin from nonzero digit if longer than divider and have size in [divider.size(), divider.size()+1]
 // \param divider is simple divider, must begin from nonzero character
-digit_t divide_almost_same_len_vectors(container_type& dividend_and_remainder, const container_type& divider)
+// \param multiplicated is scratch space, its buffer is reused
+digit_t divide_almost_same_len_vectors(container_type& dividend_and_remainder, const container_type& divider, container_type& multiplicated)
 {
     LA_ASSERT(dividend_and_remainder.size() && divider.size());
     LA_ASSERT(dividend_and_remainder.size() >= divider.size() && dividend_and_remainder.size() <= divider.size() + 1);
@@ -469,122 +1040,72 @@ digit_t divide_almost_same_len_vectors(container_type& dividend_and_remainder, c
 
     // if (abs_cmp < 0)
 
-    // Divide first digits to get result
-    compute_t dividend_beg, divider_beg;
-    if (dividend_and_remainder.size() > divider.size())
+    // Estimate fraction digit by most significant digits: two of divider and three of dividend.
+    // Skipped digits change ratio by less than 1/DigitBase of it, so estimate is wrong by few units
+    const size_t divider_size = divider.size();
+    const bool longer = dividend_and_remainder.size() > divider_size;
+    double dividend_beg = static_cast<double>(dividend_and_remainder[divider_size - 1]);
+    double divider_beg = static_cast<double>(divider[divider_size - 1]);
+    if (longer)
     {
-        dividend_beg = TO_COMPUTE_T(dividend_and_remainder.back())*DigitBase + *(dividend_and_remainder.end() - 2);
+        dividend_beg += static_cast<double>(dividend_and_remainder[divider_size]) * DigitBase;
     }
-    else
-    {
-        dividend_beg = dividend_and_remainder.back();
-    }
-    divider_beg = divider.back();
-
-    // Try to divide most significant digits
-    compute_t main_div = dividend_beg / divider_beg;
-    container_type multiplicated(divider);
-    mult_small(multiplicated, main_div);
-    auto cmp = compare_absolute_vectors(dividend_and_remainder, multiplicated);
-    if (cmp <= 0) // if multiplicated less or equal to dividend
+    if (divider_size > 1)
     {
-        substract_array(dividend_and_remainder, multiplicated);
-        return TO_DIGIT_T(main_div);
+        dividend_beg += static_cast<double>(dividend_and_remainder[divider_size - 2]) / DigitBase;
+        divider_beg += static_cast<double>(divider[divider_size - 2]) / DigitBase;
     }
+    compute_t estimate = static_cast<compute_t>(dividend_beg / divider_beg);
+    estimate = std::max<compute_t>(0, std::min<compute_t>(estimate, DigitBase - 1));
 
-    // Start to search good divider, because 1th digit/
-    compute_t lower_div = dividend_beg / (divider_beg + 1);
-    // check lower_div
     multiplicated = divider;
-    mult_small(multiplicated, lower_div);
-    LA_ASSERT(compare_absolute_vectors(multiplicated, dividend_and_remainder) > 0);
-    substract_array(dividend_and_remainder, multiplicated);
-    if (compare_absolute_vectors(dividend_and_remainder, divider) > 0)
-    {
-        return TO_DIGIT_T(lower_div);
-    }
-    else
+    mult_small(multiplicated, estimate);
+    // Too big estimate
+    while (compare_absolute_vectors(dividend_and_remainder, multiplicated) > 0)
     {
-        add_array(dividend_and_remainder, multiplicated, 0);
+        --estimate;
+        substract_array(multiplicated, divider);
     }
-
-    // Binary search of multiplier
-    // O(log2 of DigitBase multiplications)
-    compute_t upper = main_div; // upper is too big multiplier
-    compute_t lower = lower_div; // lower is too small multiplier
-    while (1)
+    substract_array(dividend_and_remainder, multiplicated);
+    // Too small estimate
+    while (compare_absolute_vectors(dividend_and_remainder, divider) <= 0)
     {
-        if (upper - lower <= 5)
-        {
-            compute_t mult;
-            for (mult = lower; mult <= upper; ++mult)
-            {
-                multiplicated = divider;
-                mult_small(multiplicated, mult);
-                const auto cmp = compare_absolute_vectors(dividend_and_remainder, multiplicated);
-                if (cmp == 0)
-                {
-                    std::fill(dividend_and_remainder.begin(), dividend_and_remainder.end(), digit_t(0));
-                    return TO_DIGIT_T(mult);
-                }
-                if (cmp > 0)
-                {
-                    substract_array(multiplicated, divider);
-                    substract_array(dividend_and_remainder, multiplicated);
-                    mult--;
-                    return TO_DIGIT_T(mult);
-                }
-            }
-            throw std::runtime_error("Something wrong in division part");
-        }
-        else
-        {
-            compute_t middle = lower + ((upper - lower) >> 1);
-            multiplicated = divider;
-            mult_small(multiplicated, middle);
-            const auto cmp = compare_absolute_vectors(dividend_and_remainder, multiplicated);
-            if (cmp == 0) // if exact match 
-            {
-                std::fill(dividend_and_remainder.begin(), dividend_and_remainder.end(), digit_t(0));
-                return TO_DIGIT_T(middle);
-            }
-            bool middle_less = cmp < 0;
-            if (middle_less)
-            {
-                lower = middle;
-            }
-            else
-            {
-                upper = middle;
-            }
-        }
+        ++estimate;
+        substract_array(dividend_and_remainder, divider);
     }
-
-    throw std::runtime_error("Something wrong in division part");
+    LA_ASSERT(estimate < DigitBase);
+    return TO_DIGIT_T(estimate);
 }
 
 // Divide dividable by divider
 // Complexity O(divider.size()^2)*dividable.size()/divider.size() = O(m*n)
+// Works in buffers of fraction and remainder, so it doesn't allocate memory if they have enough capacity
 // \param dividable must be bigger than divider
-// \return pair of fraction and remainder
-std::pair<container_type, container_type> divide_vectors(const container_type& dividable, const container_type& divider)
+// \param fraction and remainder must be different from dividable and divider
+void divide_vectors(const container_type& dividable, const container_type& divider, container_type& fraction, container_type& remainder)
 {
     LA_ASSERT(dividable.size() >= divider.size());
-    std::deque<digit_t> fraction; // because we insert from begin, use deque
-
-    container_type current_part(dividable.end() - divider.size(), dividable.end());
+    LA_ASSERT(&fraction != &dividable && &fraction != &divider && &remainder != &dividable && &remainder != &divider);
+    // Scratch space for search of fraction digits, it keeps capacity between calls if it is small
+    static thread_local container_type multiplicated;
+    fraction.clear(); // digits are pushed from most significant and reversed at end
+
+    container_type& current_part = remainder;
+    current_part.resize(divider.size());
+    memcpy(&current_part[0], dividable.end() - divider.size(), divider.size() * sizeof(digit_t));
     size_t not_checked_len = dividable.size() - divider.size();
     bool last = !not_checked_len;
     while (not_checked_len || last)
     {
-        digit_t r = divide_almost_same_len_vectors(current_part, divider);
-        fraction.push_front(r);
+        digit_t r = divide_almost_same_len_vectors(current_part, divider, multiplicated);
+        fraction.push_back(r);
 
         if (current_part.size() != divider.size())
         {
             const size_t old = current_part.size();
             current_part.resize(divider.size());
-            std::fill(&current_part[old], &current_part[old] + (divider.size() - old), 0);
+            if (old < divider.size())
+                std::fill(&current_part[old], &current_part[old] + (divider.size() - old), 0);
         }
 
         size_t lead_zero_count = 0;
@@ -609,7 +1130,7 @@ std::pair<container_type, container_type> divide_vectors(const container_type& d
 
                 for (size_t i = 1; i < next_shift; ++i) // We add zeros in places of skiped positions
                 {
-                    fraction.push_front(0);
+                    fraction.push_back(0);
                 }
             }
         }
@@ -637,15 +1158,132 @@ std::pair<container_type, container_type> divide_vectors(const container_type& d
         if (!not_checked_len) // If it here, we end
             last = !last; // !last for handle not_checked_len==0 in first time, false in all other
     }
-    container_type fr(fraction.begin(), fraction.end());
-    clean_leading_zeros(fr);
+    std::reverse(fraction.begin(), fraction.end());
+    clean_leading_zeros(fraction);
     clean_leading_zeros(current_part);
-    return std::make_pair(std::move(fr), std::move(current_part));
+    release_big_scratch(multiplicated);
 }
 
 
 
-#pragma endregion
+// Division of digits by divider from most significant digit
+// \return remainder
+template<typename wide_t>
+static wide_t divide_digits_by_plain(const container_type& dividable, const wide_t divider, container_type& fraction)
+{
+    const size_t dividable_size = dividable.size();
+    fraction.resize(dividable_size);
+    wide_t remainder = 0;
+    for (size_t i1 = dividable_size; i1 > 0; --i1)
+    {
+        const size_t i = i1 - 1;
+        const wide_t value = dividable[i] + remainder * DigitBase;
+        fraction[i] = TO_DIGIT_T(value / divider);
+        remainder = value % divider;
+    }
+    clean_leading_zeros(fraction);
+    return remainder;
+}
+
+// Inverse of value modulo DigitBase
+// \param value must be coprime with 10
+static compute_t inverse_by_digit_base(const compute_t value)
+{
+    // Extended Euclidean algorithm
+    compute_t t = 0, new_t = 1, r = DigitBase, new_r = value;
+    while (new_r)
+    {
+        const compute_t q = r / new_r;
+        std::tie(t, new_t) = std::make_tuple(new_t, t - q * new_t);
+        std::tie(r, new_r) = std::make_tuple(new_r, r - q * new_r);
+    }
+    LA_ASSERT(r == 1);
+    return (t < 0) ? t + DigitBase : t;
+}
+
+// Exact division from least significant digit (Jebelean)
+// Every digit of fraction is got by one multiplication on inverse of lowest digit of divider,
+// and only digits which are lower than size of fraction are updated
+// Complexity O(m*(n-m))
+// \param dividable and divider are changed: their common zero digits and factors 2 and 5 are removed
+// \return fraction, it is correct only if remainder is zero
+static container_type divexact_vectors(container_type& dividable, container_type& divider)
+{
+    typedef unsigned long long ull;
+    // Lowest digit of divider must be invertible modulo DigitBase
+    while (true)
+    {
+        size_t zero_digits = 0;
+        while (!divider[zero_digits])
+            ++zero_digits;
+        if (zero_digits)
+        {
+            divider = container_type(divider.begin() + zero_digits, divider.end());
+            if (dividable.size() <= zero_digits)
+                return zero_vector();
+            dividable = container_type(dividable.begin() + zero_digits, dividable.end());
+        }
+
+        // Every such factor divides DigitBase, so it divides whole divider if it divides its lowest digit
+        digit_t low = divider[0], factor = 1;
+        for (size_t i = 0; i < DigitStringLength && !(low % 2); ++i)
+        {
+            low /= 2;
+            factor *= 2;
+        }
+        for (size_t i = 0; i < DigitStringLength && !(low % 5); ++i)
+        {
+            low /= 5;
+            factor *= 5;
+        }
+        if (factor == 1)
+            break;
+        divide_digits_by_plain<ull>(divider, factor, divider);
+        divide_digits_by_plain<ull>(dividable, factor, dividable);
+    }
+
+    const size_t divider_size = divider.size();
+    if (dividable.size() < divider_size)
+        return zero_vector();
+    const size_t fraction_size = dividable.size() - divider_size + 1;
+    const compute_t inverse = inverse_by_digit_base(divider[0]);
+    container_type fraction(fraction_size);
+    fraction.resize(fraction_size);
+    for (size_t i = 0; i < fraction_size; ++i)
+    {
+        const compute_t q = (TO_COMPUTE_T(dividable[i]) * inverse) % DigitBase;
+        fraction[i] = TO_DIGIT_T(q);
+        if (!q)
+            continue;
+        // dividable -= q*divider*DigitBase^i, digits above fraction_size are never read
+        const size_t last = std::min(i + divider_size, fraction_size);
+        compute_t trans_product = 0, borrow = 0;
+        for (size_t k = i; k < last; ++k)
+        {
+            trans_product += q * divider[k - i];
+            compute_t diff = TO_COMPUTE_T(dividable[k]) - trans_product % DigitBase - borrow;
+            trans_product /= DigitBase;
+            borrow = diff < 0;
+            dividable[k] = TO_DIGIT_T(borrow ? diff + DigitBase : diff);
+        }
+        trans_product += borrow;
+        for (size_t k = last; trans_product && k < fraction_size; ++k)
+        {
+            compute_t diff = TO_COMPUTE_T(dividable[k]) - trans_product % DigitBase;
+            trans_product /= DigitBase;
+            if (diff < 0)
+            {
+                diff += DigitBase;
+                ++trans_product;
+            }
+            dividable[k] = TO_DIGIT_T(diff);
+        }
+    }
+    clean_leading_zeros(fraction);
+    return fraction;
+}
+
+#pragma endregion
 
 
 #pragma region Class Methods
@@ -715,28 +1353,19 @@ LongArith& LongArith::operator+=(LongArith&& change)&
     return *this;
 }
 
-LongArith& LongArith::operator+=(long change)&
+void LongArith::add_native(const bool negative, const native_uint_t magnitude)
 {
-    // Handle extreme values safely
-    if (std::numeric_limits<compute_t>::max() < std::numeric_limits<long>::max() || change > DigitBase*DigitBase || change < -DigitBase*DigitBase)
-    {
-        return *this += LongArith(change);
-    }
-
-    if (get_negative() == change < 0)
+    digit_t digits[NativeDigitCount];
+    const size_t count = split_native(magnitude, digits);
+    if (get_negative() == negative)
     {
-        compute_t change_b(change); // to avoid integer overflow
-        increment_array(storage, change_b < 0 ? -change_b : change_b);
+        add_digits(storage, digits, count);
     }
-    else
+    else if (substract_digits(storage, digits, count))
     {
-        const bool old_negative = get_negative();
-        digit_t add = (change < 0) ? -change : change;
-        const bool not_changed_sign = decrement_array(storage, add);
-        set_negative(not_changed_sign == old_negative);
+        set_negative(negative);
     }
     check_zero();
-    return *this;
 }
 
 
@@ -756,18 +1385,6 @@ LongArith& LongArith::operator++()&
     return *this;
 }
 
-LongArith& LongArith::operator-=(long change)&
-{
-    if (std::numeric_limits<long>::min() == change)
-    {
-        ++*this;
-        ++change;
-    }
-    return this->operator+=(-change);
-}
-
-
-
 LongArith& LongArith::operator--()&
 {
     // this variant runs 1.4x faster than this-=1
@@ -787,70 +1404,135 @@ LongArith& LongArith::operator--()&
 
 // Multiplication
 LongArith operator*(const LongArith& a, const LongArith& b)
+{
+    return LongArith::multiply(a, b, LongArith::ExecutionPolicy::sequential());
+}
+
+LongArith LongArith::multiply(const LongArith& a, const LongArith& b, const ExecutionPolicy policy)
 {
     LongArith res(0);
     if (!(a.equals_zero() || b.equals_zero()))
     {
-        res.storage = mult_big(a.storage, b.storage);
+        const size_t products = a.storage.size() * b.storage.size();
+        const size_t threads = std::max<size_t>(1, std::min(policy.thread_count(), products / ParallelMinMultProducts));
+        res.storage = mult_big(a.storage, b.storage, threads);
         res.set_negative(a.get_negative() != b.get_negative());
     }
     return res;
 }
 
 
-LongArith& LongArith::operator*=(long multiplier)&
+LongArith& LongArith::operator*=(const LongArith& multiplier)&
 {
-    const bool calculated_negative = get_negative() != (multiplier < 0);
-    if (multiplier < 0)
+    if (multiplier.storage.size() == 1) // Multiply in place without copying
     {
-        if (multiplier == std::numeric_limits<long>::min())
-        {
-            return *this *= LongArith(multiplier);
-        }
-        multiplier = -multiplier;
+        const bool calculated_negative = get_negative() != multiplier.get_negative();
+        mult_small(storage, multiplier.storage[0]);
+        set_negative(calculated_negative);
+        check_zero();
+        return *this;
     }
-    mult_small(storage, multiplier);
+    return (*this = (*this)*multiplier);
+}
+
+void LongArith::mult_native(const bool negative, const native_uint_t magnitude)
+{
+    const bool calculated_negative = get_negative() != negative;
+    digit_t digits[NativeDigitCount];
+    const size_t count = split_native(magnitude, digits);
+    mult_digits(storage, digits, count);
     set_negative(calculated_negative);
-    return *this;
+    check_zero();
 }
 
 
-std::pair<LongArith, LongArith> LongArith::fraction_and_remainder(const LongArith& dividable, const LongArith& divider)
+void LongArith::divmod(const LongArith& dividable, const LongArith& divider, LongArith& fraction, LongArith& remainder)
 {
-    typedef std::pair<LongArith, LongArith> t_result;
     // Argument check
     if (divider.equals_zero())
     {
         throw std::logic_error("Division by zero");
     }
+    if (&fraction == &remainder)
+    {
+        throw std::logic_error("Fraction and remainder must be different objects");
+    }
+
+    // Remember signs before outputs are written, they can be same objects as arguments
+    const bool dividable_negative = dividable.get_negative();
+    const bool fraction_negative = dividable_negative != divider.get_negative();
 
     // Simple Cases
     if (dividable.equals_zero())
     {
-        return t_result(0, 0);
+        fraction.assign_native(false, 0);
+        remainder.assign_native(false, 0);
+        return;
     }
     const int abs_compare = LongArith::compare_absolute_values(dividable, divider);
     if (abs_compare == 0)
     {
-        return t_result(LongArith((dividable.get_negative() == divider.get_negative()) ? 1 : -1),
-            LongArith(0));
+        fraction.assign_native(fraction_negative, 1);
+        remainder.assign_native(false, 0);
+        return;
     }
     if (abs_compare > 0)
     {
-        return t_result(0, dividable);
+        remainder = dividable;
+        fraction.assign_native(false, 0);
+        return;
     }
 
     // Here divider is always lower than dividable
 
-    LongArith fraction, remainder;
-    std::tie(fraction.storage, remainder.storage) = divide_vectors(dividable.storage, divider.storage);
-    fraction.set_negative(dividable.get_negative() != divider.get_negative());
-    remainder.set_negative(dividable.get_negative());
+    // Arguments which are also outputs are copied to buffers that keep capacity between calls if they are small
+    static thread_local container_type dividable_copy, divider_copy;
+    const container_type* dividable_digits = &dividable.storage;
+    const container_type* divider_digits = &divider.storage;
+    if (&dividable == &fraction || &dividable == &remainder)
+    {
+        dividable_copy = dividable.storage;
+        dividable_digits = &dividable_copy;
+    }
+    if (&divider == &fraction || &divider == &remainder)
+    {
+        divider_copy = divider.storage;
+        divider_digits = &divider_copy;
+    }
+
+    divide_vectors(*dividable_digits, *divider_digits, fraction.storage, remainder.storage);
+    release_big_scratch(dividable_copy);
+    release_big_scratch(divider_copy);
+    fraction.set_negative(fraction_negative);
+    remainder.set_negative(dividable_negative);
+    fraction.check_zero();
+    remainder.check_zero();
+}
+
+std::pair<LongArith, LongArith> LongArith::fraction_and_remainder(const LongArith& dividable, const LongArith& divider)
+{
+    std::pair<LongArith, LongArith> result;
+    divmod(dividable, divider, result.first, result.second);
+    return result;
+}
+
+LongArith& LongArith::operator/=(const LongArith& divider)&
+{
+    static thread_local LongArith remainder;
+    divmod(*this, divider, *this, remainder);
+    release_big_scratch(remainder.storage);
+    return *this;
+}
 
-    return t_result(std::move(fraction), std::move(remainder));
+LongArith& LongArith::operator%=(const LongArith& divider)&
+{
+    static thread_local LongArith fraction;
+    divmod(*this, divider, fraction, *this);
+    release_big_scratch(fraction.storage);
+    return *this;
 }
 
-std::pair<LongArith, long> LongArith::fraction_and_remainder(const LongArith & dividable, const long divider)
+LongArith::native_uint_t LongArith::divide_native(const LongArith& dividable, const native_uint_t divider, LongArith& fraction)
 {
     // Argument check
     if (!divider)
@@ -858,43 +1540,124 @@ std::pair<LongArith, long> LongArith::fraction_and_remainder(const LongArith & d
         throw std::logic_error("Division by zero");
     }
 
-    typedef std::pair<LongArith, long> t_result;
+    // remainder*DigitBase + digit must fit in wide type
+    typedef unsigned long long ull;
+    if (divider <= (std::numeric_limits<ull>::max() - DigitBase) / DigitBase)
+    {
+        return divide_digits_by_plain<ull>(dividable.storage, static_cast<ull>(divider), fraction.storage);
+    }
+    if (sizeof(native_uint_t) > sizeof(ull) && divider <= std::numeric_limits<ull>::max())
+    {
+        return divide_digits_by_plain<native_uint_t>(dividable.storage, divider, fraction.storage);
+    }
 
-    if (divider == 1)
+    // Divider has several digits
+    LongArith long_divider(divider);
+    LongArith abs_dividable(dividable);
+    abs_dividable.set_negative(false);
+    auto res = fraction_and_remainder(abs_dividable, long_divider);
+    fraction.storage = std::move(res.first.storage);
+    native_uint_t remainder = 0;
+    for (size_t i1 = res.second.storage.size(); i1 > 0; --i1)
     {
-        return t_result(dividable, 0);
+        remainder = remainder * DigitBase + res.second.storage[i1 - 1];
     }
+    return remainder;
+}
 
-    if (divider == -1)
+LongArith LongArith::divexact(const LongArith& divider) const
+{
+    if (divider.equals_zero())
     {
-        return t_result(-dividable, 0);
+        throw std::logic_error("Division by zero");
     }
+    LongArith result;
+    if (equals_zero())
+        return result;
 
-    if (std::numeric_limits<long>::min() == divider)
+    container_type dividable_digits(storage), divider_digits(divider.storage);
+    result.storage = divexact_vectors(dividable_digits, divider_digits);
+    result.set_negative(get_negative() != divider.get_negative());
+    result.check_zero();
+#if defined(LONGARITH_CHECK_DIVEXACT)
+    if (result * divider != *this)
     {
-        auto res = fraction_and_remainder(dividable, LongArith(divider));
-        return t_result(std::move(res.first), static_cast<long>(res.second.to_plain_int()));
+        throw std::logic_error("Division is not exact");
     }
+#endif
+    return result;
+}
 
-    const unsigned long u_div = (divider >= 0) ? divider : -divider;
+LongArith LongArith::divexact_native(const bool negative, const native_uint_t magnitude) const
+{
+    if (!magnitude)
+    {
+        throw std::logic_error("Division by zero");
+    }
+    LongArith result;
+    if (equals_zero())
+        return result;
 
-    LongArith fraction;
-    unsigned long remainder = 0;
-    for (size_t i1 = dividable.storage.size(); i1 > 0; --i1)
+    digit_t digits[NativeDigitCount];
+    const size_t count = split_native(magnitude, digits);
+    container_type dividable_digits(storage), divider_digits(digits, digits + count);
+    result.storage = divexact_vectors(dividable_digits, divider_digits);
+    result.set_negative(get_negative() != negative);
+    result.check_zero();
+#if defined(LONGARITH_CHECK_DIVEXACT)
+    LongArith check(result);
+    check.mult_native(negative, magnitude);
+    if (check != *this)
     {
-        const size_t i = i1 - 1;
-        const compute_t value = dividable.storage[i] + remainder*DigitBase;
-        fraction.storage.push_back(TO_DIGIT_T(value / u_div));
-        remainder = value % u_div;
+        throw std::logic_error("Division is not exact");
     }
+#endif
+    return result;
+}
 
-    std::reverse(fraction.storage.begin(), fraction.storage.end());
-    clean_leading_zeros(fraction.storage);
+// How many lowest columns mul_high still computes below requested digits
+// With 2 guard columns skipped part is less than min(a,b).size()*DigitBase^(k-1) which is less than one unit of result
+constexpr size_t MulHighGuardDigits = 2;
+
+LongArith LongArith::mul_low(const LongArith& a, const LongArith& b, const size_t nlimbs)
+{
+    LongArith result;
+    const size_t full_size = a.storage.size() + b.storage.size();
+    if (!nlimbs || a.equals_zero() || b.equals_zero())
+        return result;
+    if (nlimbs >= full_size)
+        return a * b;
+
+    result.storage.resize(nlimbs);
+    std::fill(result.storage.begin(), result.storage.end(), 0);
+    mult_low_basecase(a.storage.begin(), a.storage.size(), b.storage.begin(), b.storage.size(), result.storage.begin(), nlimbs);
+    clean_leading_zeros(result.storage);
+    result.set_negative(a.get_negative() != b.get_negative());
+    result.check_zero();
+    return result;
+}
 
-    fraction.set_negative(divider < 0 != dividable.get_negative());
-    const signed long signed_remainder = dividable.get_negative() ? -static_cast<signed long>(remainder) : remainder;
+LongArith LongArith::mul_high(const LongArith& a, const LongArith& b, const size_t nlimbs)
+{
+    const size_t full_size = a.storage.size() + b.storage.size();
+    if (!nlimbs || a.equals_zero() || b.equals_zero())
+        return LongArith();
+    if (nlimbs + MulHighGuardDigits >= full_size)
+        return (a * b).fast_divide_by_10((full_size - std::min(nlimbs, full_size)) * DigitStringLength);
+
+    const size_t skipped = full_size - nlimbs;
+    const size_t first_column = skipped - MulHighGuardDigits;
+    container_type product(full_size - first_column);
+    product.resize(full_size - first_column);
+    std::fill(product.begin(), product.end(), 0);
+    mult_high_basecase(a.storage.begin(), a.storage.size(), b.storage.begin(), b.storage.size(), product.begin(), first_column);
 
-    return t_result(std::move(fraction), signed_remainder);
+    LongArith result;
+    result.storage = container_type(product.begin() + MulHighGuardDigits, product.end());
+    clean_leading_zeros(result.storage);
+    result.set_negative(a.get_negative() != b.get_negative());
+    result.check_zero();
+    return result;
 }
 
 // Utility for constant calculation
@@ -914,48 +1677,164 @@ namespace hidden
 }
 const static size_t DecimalDigitLen = hidden::len_10_in_DIGIT_BASE();
 
-LongArith LongArith::fast_divide_by_10(const size_t power) const
+// 10^power for power < DecimalDigitLen
+static inline digit_t small_power_of_10(const size_t power)
 {
-    if (!power)
-        return *this;
+    LA_ASSERT(power < DecimalDigitLen);
+    digit_t result = 1;
+    for (size_t i = 0; i < power; ++i)
+        result *= 10;
+    return result;
+}
 
+// Divides absolute value by 10^power in place
+// Whole digits are dropped, rest of power is applied by one pass without wide division
+static void divide_digits_by_power_of_10(container_type& digits, const size_t power)
+{
     const size_t digits_skipped = power / DecimalDigitLen;
-    const size_t remain = power % DecimalDigitLen;
-    digit_t remain_div = 1;
-    for (size_t i = 0; i < remain; ++i)
-        remain_div *= 10;
+    if (digits_skipped >= digits.size())
+    {
+        digits.resize(1);
+        digits[0] = 0;
+        return;
+    }
+    if (digits_skipped)
+    {
+        const size_t new_size = digits.size() - digits_skipped;
+        memmove(digits.begin(), digits.begin() + digits_skipped, sizeof(digit_t)*new_size);
+        digits.resize(new_size);
+    }
 
-    if (digits_skipped >= storage.size() || (digits_skipped == storage.size() - 1 && remain_div > storage.back()))
-        return LongArith(0);
+    const digit_t remain_div = small_power_of_10(power % DecimalDigitLen);
+    if (remain_div == 1)
+        return;
+    const digit_t remain_mult = TO_DIGIT_T(DigitBase / remain_div);
+    const size_t last = digits.size() - 1;
+    for (size_t i = 0; i < last; ++i)
+        digits[i] = digits[i] / remain_div + (digits[i + 1] % remain_div) * remain_mult;
+    digits[last] /= remain_div;
+    clean_leading_zeros(digits);
+}
 
-    LongArith result;
-    result.storage.resize(storage.size() - digits_skipped);
-    memcpy(&result.storage[0], &storage[digits_skipped], sizeof(digit_t)*(storage.size() - digits_skipped));
+// Multiplies absolute value by 10^power in place
+static void multiply_digits_by_power_of_10(container_type& digits, const size_t power)
+{
+    if (digits.size() == 1 && !digits[0])
+        return;
 
-    if (remain_div == 1)
+    const digit_t remain_mult = small_power_of_10(power % DecimalDigitLen);
+    if (remain_mult != 1)
     {
-        result.set_negative(get_negative());
-        result.check_zero();
-        return result;
+        const digit_t remain_div = TO_DIGIT_T(DigitBase / remain_mult);
+        digit_t carry = 0;
+        for (size_t i = 0, size = digits.size(); i < size; ++i)
+        {
+            const digit_t digit = digits[i];
+            digits[i] = (digit % remain_div) * remain_mult + carry;
+            carry = digit / remain_div;
+        }
+        if (carry)
+            digits.push_back(carry);
     }
 
-    for (size_t i = 0; i + 1 < result.storage.size(); ++i)
+    const size_t digits_added = power / DecimalDigitLen;
+    if (digits_added)
     {
-        compute_t next_digit_summed = TO_COMPUTE_T(result.storage[i + 1]) * DigitBase + result.storage[i];
-        result.storage[i] = TO_DIGIT_T((next_digit_summed / remain_div) % DigitBase);
+        const size_t old_size = digits.size();
+        digits.resize(old_size + digits_added);
+        memmove(digits.begin() + digits_added, digits.begin(), sizeof(digit_t)*old_size);
+        std::fill(digits.begin(), digits.begin() + digits_added, digit_t(0));
     }
-    if (result.storage.back() >= remain_div)
+}
+
+// Compares part of absolute value below 10^power with half of 10^power
+// \return -1 if part is less, 0 if equal, 1 if bigger; part_is_zero tells if it is zero
+static int compare_lower_part_with_half(const container_type& digits, const size_t power, bool& part_is_zero)
+{
+    part_is_zero = true;
+    if (!power)
+        return -1;
+    // Most significant decimal digit of part decides unless it is 5
+    const size_t position = power - 1;
+    const size_t index = position / DecimalDigitLen;
+    if (index >= digits.size())
     {
-        result.storage[result.storage.size() - 1] = result.storage.back() / remain_div;
+        for (size_t i = 0; i < digits.size() && part_is_zero; ++i)
+            part_is_zero = !digits[i];
+        return -1;
     }
-    else
+    const digit_t lower_div = small_power_of_10(position % DecimalDigitLen);
+    const digit_t first = (digits[index] / lower_div) % 10;
+    bool rest_is_zero = !(digits[index] % lower_div);
+    for (size_t i = 0; i < index && rest_is_zero; ++i)
+        rest_is_zero = !digits[i];
+    part_is_zero = rest_is_zero && !first;
+    if (first != 5)
+        return first > 5 ? 1 : -1;
+    return rest_is_zero ? 0 : 1;
+}
+
+// Adds one to absolute value
+static void increment_digits(container_type& digits)
+{
+    for (size_t i = 0, size = digits.size(); i < size; ++i)
     {
-        result.storage.pop_back();
+        if (++digits[i] < DigitBase)
+            return;
+        digits[i] = 0;
     }
+    digits.push_back(1);
+}
 
-    result.set_negative(get_negative());
-    result.check_zero();
-    return result;
+LongArith& LongArith::fast_divide_by_10_inplace(const size_t power, const RoundingMode mode)&
+{
+    if (!power)
+        return *this;
+
+    const bool negative = get_negative();
+    bool lower_is_zero = true;
+    const int lower_vs_half = compare_lower_part_with_half(storage, power, lower_is_zero);
+    divide_digits_by_power_of_10(storage, power);
+
+    bool away_from_zero = false;
+    switch (mode)
+    {
+    case RoundingMode::TowardZero:
+        break;
+    case RoundingMode::HalfEven:
+        away_from_zero = lower_vs_half > 0 || (lower_vs_half == 0 && (storage[0] & 1));
+        break;
+    case RoundingMode::Ceil:
+        away_from_zero = !lower_is_zero && !negative;
+        break;
+    case RoundingMode::Floor:
+        away_from_zero = !lower_is_zero && negative;
+        break;
+    }
+    if (away_from_zero)
+        increment_digits(storage);
+
+    set_negative(negative);
+    check_zero();
+    return *this;
+}
+
+std::pair<LongArith, LongArith> LongArith::fast_divmod_by_10(const size_t power)&&
+{
+    LongArith remainder = fast_remainder_by_10(power);
+    fast_divide_by_10_inplace(power);
+    return std::make_pair(std::move(*this), std::move(remainder));
+}
+
+LongArith& LongArith::fast_multiply_by_10_inplace(const size_t power)&
+{
+    multiply_digits_by_power_of_10(storage, power);
+    return *this;
+}
+
+size_t LongArith::decimal_digits() const noexcept
+{
+    return (storage.size() - 1) * DigitStringLength + get_digit_count(storage.back());
 }
 
 LongArith LongArith::fast_remainder_by_10(const size_t power) const
@@ -1066,74 +1945,151 @@ int LongArith::sign() const noexcept
 }
 
 
-std::ostream& operator<<(std::ostream& os, const LongArith& obj)
-{
-    return os << obj.to_string();
-}
+// How many digits are formatted on stack before they are passed to stream buffer
+constexpr size_t StreamBlockDigits = 64;
 
-std::istream& operator >> (std::istream& is, LongArith& obj)
+std::ostream& operator<<(std::ostream& os, const LongArith& obj)
 {
-    std::string s;
-    std::istream& r = is >> s;
-
-    try
+    std::ostream::sentry sentry(os);
+    if (!sentry)
+        return os;
+
+    // Width and fill are handled here, because text is not built as one string
+    const size_t length = obj.decimal_length();
+    const std::streamsize width = os.width();
+    const size_t padding = (width > 0 && static_cast<size_t>(width) > length) ? static_cast<size_t>(width) - length : 0;
+    const std::ios_base::fmtflags adjust = os.flags() & std::ios_base::adjustfield;
+    std::streambuf* buffer = os.rdbuf();
+    bool good = true;
+    const auto put_padding = [&]()
     {
-        obj = LongArith::from_string(s);
-    }
-    catch (std::invalid_argument&)
+        for (size_t i = 0; i < padding && good; ++i)
+            good = !std::char_traits<char>::eq_int_type(buffer->sputc(os.fill()), std::char_traits<char>::eof());
+    };
+
+    if (adjust != std::ios_base::left && adjust != std::ios_base::internal)
+        put_padding();
+    if (obj.get_negative() && !obj.equals_zero())
+        good = good && !std::char_traits<char>::eq_int_type(buffer->sputc('-'), std::char_traits<char>::eof());
+    if (adjust == std::ios_base::internal)
+        put_padding();
+
+    char block[StreamBlockDigits * DigitStringLength];
+    const size_t back_length = get_digit_count(obj.storage.back());
+    write_digit(obj.storage.back(), block, back_length);
+    size_t block_length = back_length;
+    for (size_t index = obj.storage.size() - 1; index && good; --index)
     {
-        obj = 0;
+        if (block_length + DigitStringLength > sizeof(block))
+        {
+            good = buffer->sputn(block, block_length) == static_cast<std::streamsize>(block_length);
+            block_length = 0;
+        }
+        write_digit_padded(obj.storage[index - 1], block + block_length);
+        block_length += DigitStringLength;
     }
-
-    return r;
+    good = good && buffer->sputn(block, block_length) == static_cast<std::streamsize>(block_length);
+
+    if (adjust == std::ios_base::left)
+        put_padding();
+    os.width(0);
+    if (!good)
+        os.setstate(std::ios_base::badbit);
+    return os;
 }
 
-LongArith::LongArith(long default_value) :storage()
+std::istream& operator >> (std::istream& is, LongArith& obj)
 {
-    const bool negativity = default_value < 0;
-    // Avoiding integer overflow
-    if (default_value == std::numeric_limits<long>::min())
+    std::istream::sentry sentry(is); // skips whitespaces
+    if (!sentry)
+        return is;
+
+    typedef std::char_traits<char> traits;
+    std::streambuf* buffer = is.rdbuf();
+    // Digits are parsed to local container and moved to obj only on success,
+    // so obj keeps its value if stream buffer throws
+    container_type digits;
+
+    // Total length is unknown, so characters are grouped from most significant one.
+    // Full groups are parsed as soon as they are read
+    char group[DigitStringLength];
+    size_t group_length = 0;
+    bool negative = false, has_digits = false;
+    traits::int_type c = buffer->sgetc();
+    if (traits::eq_int_type(c, '-') || traits::eq_int_type(c, '+'))
     {
-        default_value += 2;
-        storage.push_back(2);
+        negative = traits::eq_int_type(c, '-');
+        c = buffer->snextc();
     }
-    else
+    while (traits::eq_int_type(c, '0')) // leading zeros would make zero digits
     {
-        storage.push_back(0);
+        has_digits = true;
+        c = buffer->snextc();
     }
-
-    if (default_value == 0)
+    while (!traits::eq_int_type(c, traits::eof()) && traits::to_char_type(c) >= '0' && traits::to_char_type(c) <= '9')
     {
-        set_negative(false);
-        return;
+        has_digits = true;
+        group[group_length++] = traits::to_char_type(c);
+        if (group_length == DigitStringLength)
+        {
+            digits.push_back(0);
+            parse_digit_padded(group, digits[digits.size() - 1]);
+            group_length = 0;
+        }
+        c = buffer->snextc();
     }
 
-    if (default_value < 0)
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    if (traits::eq_int_type(c, traits::eof()))
+        state |= std::ios_base::eofbit;
+    if (!has_digits)
     {
-        default_value = -default_value;
+        obj = 0;
+        is.setstate(state | std::ios_base::failbit);
+        return is;
     }
 
-    if (std::numeric_limits<long>::max() > std::numeric_limits<compute_t>::max() && default_value > static_cast<long>(std::numeric_limits<compute_t>::max()))
+    // Last group is padded by zeros, so whole number is shifted left by DigitStringLength - group_length characters.
+    // Single pass of division by power of 10 moves it back
+    digit_t shift_div = 1;
+    if (group_length)
     {
-        container_type temp;
-        while (default_value)
+        digit_t tail = 0;
+        for (size_t i = 0; i < DigitStringLength; ++i)
         {
-            temp.push_back(default_value % DigitBase);
-            default_value /= DigitBase;
+            tail = tail * 10 + ((i < group_length) ? static_cast<digit_t>(group[i] - '0') : 0);
+            if (i >= group_length)
+                shift_div *= 10;
         }
-        add_array(storage, temp, 0);
+        digits.push_back(tail);
     }
-    else if (static_cast<compute_t>(default_value) > std::numeric_limits<compute_t>::max() - 3)
+    if (!digits.size())
+        digits.push_back(0);
+    std::reverse(digits.begin(), digits.end());
+    if (shift_div > 1)
     {
-        increment_array(storage, default_value / 2);
-        increment_array(storage, default_value - (default_value / 2));
+        const unsigned long long remainder = divide_digits_by_plain<unsigned long long>(digits, shift_div, digits);
+        LA_ASSERT(!remainder);
+        (void)remainder;
     }
-    else
+    clean_leading_zeros(digits);
+    obj.storage = std::move(digits);
+    obj.set_negative(negative);
+    obj.check_zero();
+    is.setstate(state);
+    return is;
+}
+
+void LongArith::assign_native(const bool negative, const native_uint_t magnitude)
+{
+    digit_t digits[NativeDigitCount];
+    const size_t count = split_native(magnitude, digits);
+    storage.clear();
+    for (size_t i = 0; i < count; ++i)
     {
-        increment_array(storage, default_value);
+        storage.push_back(digits[i]);
     }
-
-    set_negative(negativity);
+    set_negative(negative && magnitude);
 }
 
 LongArith::LongArith() :storage()
@@ -1141,79 +2097,2012 @@ LongArith::LongArith() :storage()
     storage.push_back(0);
 }
 
-std::string LongArith::to_string() const
+size_t LongArith::decimal_length() const noexcept
 {
-    std::string res;
-    res.reserve(storage.size()*LongArith::DigitStringLength + int(get_negative()));
+    const size_t sign_length = (get_negative() && !equals_zero()) ? 1 : 0;
+    return sign_length + (storage.size() - 1) * DigitStringLength + get_digit_count(storage.back());
+}
+
+// Writes digits of number without sign, returns pointer after last character
+// Digits below most significant one are written to disjoint places, so they can be written by several threads
+static char* write_digits(const container_type& digits, char* out, const size_t threads)
+{
+    const size_t back_length = get_digit_count(digits.back());
+    write_digit(digits.back(), out, back_length);
+    char* const body = out + back_length;
+    const size_t count = digits.size() - 1;
+    parallel_for(count, threads, [&digits, body, count](const size_t begin, const size_t end)
+    {
+        for (size_t k = begin; k < end; ++k)
+            write_digit_padded(digits[count - 1 - k], body + k * DigitStringLength);
+    });
+    return body + count * DigitStringLength;
+}
+
+char* LongArith::to_chars(char* first, char* last) const
+{
+    if (last < first || static_cast<size_t>(last - first) < decimal_length())
+        return nullptr;
 
     if (get_negative() && !equals_zero())
-        res += '-';
-    res += std::to_string(storage.back());
-    for (size_t index = storage.size() - 1; index; --index)
+        *first++ = '-';
+    return write_digits(storage, first, 1);
+}
+
+std::string LongArith::to_string(const ExecutionPolicy policy) const
+{
+    std::string res(decimal_length(), '0');
+    char* out = &res[0];
+    if (get_negative() && !equals_zero())
+        *out++ = '-';
+    write_digits(storage, out, threads_for(policy, storage.size()));
+    return res;
+}
+
+LongArith::DecimalChunks::DecimalChunks(const LongArith& value) noexcept
+    : number(&value), position(0), length(value.decimal_length())
+{
+}
+
+size_t LongArith::DecimalChunks::read(char* out, const size_t size)
+{
+    const container_type& digits = number->storage;
+    const bool minus = number->get_negative() && !number->equals_zero();
+    const size_t head_length = (minus ? 1 : 0) + get_digit_count(digits.back());
+    const size_t count = std::min(size, length - position);
+    char formatted[DigitStringLength + 1];
+    size_t written = 0;
+    while (written < count)
     {
-        const size_t i = index - 1;
-        size_t digits = get_digit_count(storage[i]);
-        for (int j = 0; j < int(DigitStringLength) - digits; ++j)
+        const size_t wanted = count - written;
+        if (position < head_length) // sign and most significant digit
+        {
+            char* p = formatted;
+            if (minus)
+                *p++ = '-';
+            write_digit(digits.back(), p, head_length - (minus ? 1 : 0));
+            const size_t part = std::min(wanted, head_length - position);
+            memcpy(out + written, formatted + position, part);
+            written += part;
+            position += part;
+            continue;
+        }
+        const size_t k = (position - head_length) / DigitStringLength;
+        const size_t offset = (position - head_length) % DigitStringLength;
+        const digit_t digit = digits[digits.size() - 2 - k];
+        if (!offset && wanted >= DigitStringLength)
+        {
+            write_digit_padded(digit, out + written);
+            written += DigitStringLength;
+            position += DigitStringLength;
+        }
+        else // chunk border is inside of digit
         {
-            res += '0';
+            write_digit_padded(digit, formatted);
+            const size_t part = std::min(wanted, DigitStringLength - offset);
+            memcpy(out + written, formatted + offset, part);
+            written += part;
+            position += part;
         }
-        res += std::to_string(storage[i]);
     }
-
-    return res;
+    return written;
 }
 
+// Size of chunks which write_to_fd passes to system
+constexpr size_t FdChunkSize = 1 << 16;
 
-LongArith LongArith::from_string(const std::string& arg)
+bool LongArith::write_to_fd(const int fd) const
 {
-    using namespace std;
-    // Trim beginning
-    size_t i = 0;
-    while (i < arg.length() && (arg[i] == ' ' || arg[i] == '\t'))
-        i++;
-    if (i == arg.size() || !check_string(arg))
-        throw invalid_argument("Invalid string");
+    return for_each_decimal_chunk(FdChunkSize, [fd](const char* data, size_t size)
+    {
+        while (size)
+        {
+#if defined(_MSC_VER)
+            const int written = _write(fd, data, static_cast<unsigned>(size));
+#else
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+#endif
+            if (written <= 0)
+                return false;
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    });
+}
 
+size_t LongArith::ExecutionPolicy::thread_count() const noexcept
+{
+    if (threads)
+        return threads;
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+bool LongArith::parse_chars(const char* first, const char* last, LongArith& result, const ExecutionPolicy policy)
+{
+    if (first >= last)
+        return false;
     bool negative = false;
-    if (arg[i] == '-' || arg[i] == '+')
+    if (*first == '-' || *first == '+')
     {
-        negative = arg[i] == '-';
-        ++i;
+        negative = *first == '-';
+        ++first;
+        if (first == last)
+            return false;
     }
+    // Leading zeros would produce zero digits
+    while (last - first > 1 && *first == '0')
+        ++first;
+
+    const size_t length = last - first;
+    const size_t count = (length + DigitStringLength - 1) / DigitStringLength;
+    const size_t head_length = length - (count - 1) * DigitStringLength;
+    container_type& digits = result.storage;
+    digits.resize(count);
 
-    std::string copied;
-    if (i)
+    // Most significant digit can be shorter than DigitStringLength
+    digit_t head = 0;
+    for (const char* p = first; p != first + head_length; ++p)
     {
-        copied = std::string(arg.begin() + i, arg.end()); // Copy only if need to erase beginning
+        if (*p < '0' || *p > '9')
+            return false;
+        head = head * 10 + static_cast<digit_t>(*p - '0');
     }
+    digits[count - 1] = head;
 
-    const std::string& s = (i ? copied : arg);
-
-    // Working with digits
-    LongArith result;
-    result.set_negative(negative);
-    container_type& digits = result.storage;
-    digits.clear();
-    digits.reserve(s.length() / DigitStringLength + 1);
-    for (i = 0; i < s.length() / DigitStringLength + (s.length() % DigitStringLength > 0 ? 1 : 0); ++i)
+    // Every other digit is parsed from own DigitStringLength characters, so parts can be parsed by several threads
+    const char* const body = first + head_length;
+    const size_t body_count = count - 1;
+    std::atomic<bool> correct(true);
+    parallel_for(body_count, threads_for(policy, count), [&digits, &correct, body, body_count](const size_t begin, const size_t end)
     {
-        ssize_t left = s.length() - (i + 1) * DigitStringLength;
-        left = left >= 0 ? left : 0;
-        ssize_t right = s.length() - i * DigitStringLength;
-        digit_t tmp(0);
-        for (; left < right; left++)
+        for (size_t k = begin; k < end; ++k)
         {
-            tmp = tmp * 10 + static_cast<int>(s[left] - '0');
+            if (!parse_digit_padded(body + k * DigitStringLength, digits[body_count - 1 - k]))
+            {
+                correct.store(false, std::memory_order_relaxed);
+                return;
+            }
         }
-        digits.push_back(tmp);
+    });
+    if (!correct.load())
+        return false;
+    result.set_negative(negative);
+    result.check_zero();
+    return true;
+}
+
+LongArith LongArith::from_chars(const char* first, const char* last)
+{
+    return from_chars(ExecutionPolicy::sequential(), first, last);
+}
+
+LongArith LongArith::from_chars(const ExecutionPolicy policy, const char* first, const char* last)
+{
+    LongArith result;
+    if (!parse_chars(first, last, result, policy))
+        throw std::invalid_argument("Invalid string");
+    return result;
+}
+
+#if defined(LONGARITH_HAS_STRING_VIEW)
+LongArith LongArith::from_chars(const std::string_view s)
+{
+    return from_chars(s.data(), s.data() + s.size());
+}
+
+size_t LongArith::from_strings(const std::string_view* strings, const size_t count, LongArith* output, bool* valid, const ExecutionPolicy policy)
+{
+    size_t total_length = 0;
+    for (size_t i = 0; i < count; ++i)
+        total_length += strings[i].size();
+
+    // Every string is parsed by one thread, threads get parts of array
+    std::atomic<size_t> errors(0);
+    parallel_for(count, threads_for(policy, total_length / DigitStringLength), [&](const size_t begin, const size_t end)
+    {
+        size_t part_errors = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const bool correct = parse_chars(strings[i].data(), strings[i].data() + strings[i].size(), output[i], ExecutionPolicy::sequential());
+            if (!correct)
+            {
+                output[i] = LongArith();
+                ++part_errors;
+            }
+            if (valid)
+                valid[i] = correct;
+        }
+        errors.fetch_add(part_errors, std::memory_order_relaxed);
+    });
+    return errors.load();
+}
+
+size_t LongArith::from_strings(const std::string_view* strings, const size_t count, LongArithVector& output, bool* valid, const ExecutionPolicy policy)
+{
+    // Every value gets place for longest possible value of its string in arena,
+    // so values are written in parallel and moved together by one pass later
+    const size_t first_index = output.size();
+    std::vector<size_t> places(count + 1);
+    places[0] = output.digits.size();
+    for (size_t i = 0; i < count; ++i)
+        places[i + 1] = places[i] + std::max<size_t>(1, (strings[i].size() + DigitStringLength - 1) / DigitStringLength);
+    std::vector<size_t> sizes(count);
+    output.offsets.reserve(output.offsets.size() + count);
+
+    std::atomic<size_t> errors(0);
+    try
+    {
+        output.digits.resize(places[count]);
+        output.negative.resize(first_index + count);
+        parallel_for(count, threads_for(policy, places[count] - places[0]), [&](const size_t begin, const size_t end)
+        {
+            size_t part_errors = 0;
+            LongArith value;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const bool correct = parse_chars(strings[i].data(), strings[i].data() + strings[i].size(), value, ExecutionPolicy::sequential());
+                if (!correct)
+                {
+                    value = LongArith();
+                    ++part_errors;
+                }
+                if (valid)
+                    valid[i] = correct;
+                std::copy(value.storage.begin(), value.storage.end(), output.digits.begin() + places[i]);
+                sizes[i] = value.storage.size();
+                output.negative[first_index + i] = value.get_negative();
+            }
+            errors.fetch_add(part_errors, std::memory_order_relaxed);
+        });
+    }
+    catch (...)
+    {
+        // Elements which were being added are dropped, so output keeps its previous values
+        output.digits.resize(places[0]);
+        output.negative.resize(first_index);
+        throw;
+    }
+
+    // Capacity of offsets is reserved, so nothing throws from here
+    size_t position = places[0];
+    for (size_t i = 0; i < count; ++i)
+    {
+        memmove(output.digits.data() + position, output.digits.data() + places[i], sizeof(digit_t)*sizes[i]);
+        position += sizes[i];
+        output.offsets.push_back(position);
+    }
+    output.digits.resize(position);
+    return errors.load();
+}
+#endif
+
+LongArith LongArith::from_string(const std::string& arg)
+{
+    return from_string(ExecutionPolicy::sequential(), arg);
+}
+
+LongArith LongArith::from_string(const ExecutionPolicy policy, const std::string& arg)
+{
+    // Trim beginning
+    size_t i = 0;
+    while (i < arg.length() && (arg[i] == ' ' || arg[i] == '\t'))
+        i++;
+    return from_chars(policy, arg.data() + i, arg.data() + arg.size());
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Sums
+
+// Additions which surely fit in slot after normalization
+constexpr size_t AccumulatorMaxPending = static_cast<size_t>(std::numeric_limits<std::uint64_t>::max() / DigitBase - 2);
+
+// Products of values with not more digit multiplications are added to slots directly
+constexpr size_t AccumulatorDirectProducts = 64 * 64;
+
+// Adds digits to slots without carry propagation
+template<typename Digit>
+static void add_to_slots(std::vector<std::uint64_t>& slots, const Digit* digits, const size_t size)
+{
+    if (slots.size() < size)
+        slots.resize(size, 0);
+    std::uint64_t* target = slots.data();
+    for (size_t i = 0; i < size; ++i)
+        target[i] += digits[i];
+}
+
+// Propagates carries, every slot becomes less than DigitBase
+static void normalize_slots(std::vector<std::uint64_t>& slots)
+{
+    std::uint64_t carry = 0;
+    for (auto& slot : slots)
+    {
+        const std::uint64_t current = slot + carry;
+        slot = current % DigitBase;
+        carry = current / DigitBase;
+    }
+    for (; carry; carry /= DigitBase)
+        slots.push_back(carry % DigitBase);
+}
+
+// Digits of normalized slots
+static container_type slots_to_digits(const std::vector<std::uint64_t>& slots)
+{
+    size_t size = slots.size();
+    while (size > 1 && !slots[size - 1])
+        --size;
+    if (!size)
+        return zero_vector();
+    container_type result(size);
+    result.resize(size);
+    for (size_t i = 0; i < size; ++i)
+        result[i] = TO_DIGIT_T(slots[i]);
+    return result;
+}
+
+LongAccumulator::LongAccumulator() noexcept
+    : positive(), negative(), pending(0)
+{
+}
+
+LongAccumulator::LongAccumulator(const LongArith& initial)
+    : LongAccumulator()
+{
+    *this += initial;
+}
+
+void LongAccumulator::add(const bool negative_value, const digit_t* digits, const size_t size)
+{
+    if (pending == AccumulatorMaxPending)
+        normalize();
+    add_to_slots(negative_value ? negative : positive, digits, size);
+    ++pending;
+}
+
+void LongAccumulator::add_native(const bool negative_value, const LongArith::native_uint_t magnitude)
+{
+    digit_t digits[LongArith::NativeDigitCount];
+    const size_t count = split_native(magnitude, digits);
+    add(negative_value, digits, count);
+}
+
+void LongAccumulator::normalize()
+{
+    normalize_slots(positive);
+    normalize_slots(negative);
+    pending = 0;
+}
+
+LongAccumulator& LongAccumulator::operator+=(const LongArith& value)
+{
+    add(value.get_negative(), value.storage.begin(), value.storage.size());
+    return *this;
+}
+
+LongAccumulator& LongAccumulator::operator-=(const LongArith& value)
+{
+    add(!value.get_negative(), value.storage.begin(), value.storage.size());
+    return *this;
+}
+
+LongAccumulator& LongAccumulator::operator+=(const LongAccumulator& other)
+{
+    // Slots of other are normalized copy, so they are added as one value
+    LongAccumulator addition(other);
+    addition.normalize();
+    if (pending == AccumulatorMaxPending)
+        normalize();
+    add_to_slots(positive, addition.positive.data(), addition.positive.size());
+    add_to_slots(negative, addition.negative.data(), addition.negative.size());
+    ++pending;
+    return *this;
+}
+
+LongAccumulator& LongAccumulator::add_product(const LongArith& a, const LongArith& b)
+{
+    const size_t a_size = a.storage.size(), b_size = b.storage.size();
+    if (a_size * b_size > AccumulatorDirectProducts)
+        return *this += a * b;
+
+    // Column of slots gets low halves of products from one diagonal and high halves from previous one
+    const size_t additions = 2 * std::min(a_size, b_size);
+    if (pending + additions > AccumulatorMaxPending)
+        normalize();
+    std::vector<std::uint64_t>& slots = (a.get_negative() != b.get_negative()) ? negative : positive;
+    if (slots.size() < a_size + b_size)
+        slots.resize(a_size + b_size, 0);
+    std::uint64_t* target = slots.data();
+    const digit_t* a_digits = a.storage.begin();
+    const digit_t* b_digits = b.storage.begin();
+    for (size_t i = 0; i < a_size; ++i)
+    {
+        const std::uint64_t current = a_digits[i];
+        if (!current)
+            continue;
+        std::uint64_t* row = target + i;
+        for (size_t j = 0; j < b_size; ++j)
+        {
+            const std::uint64_t product = current * b_digits[j];
+            row[j] += product % DigitBase;
+            row[j + 1] += product / DigitBase;
+        }
+    }
+    pending += additions;
+    return *this;
+}
+
+LongArith LongAccumulator::to_LongArith() const
+{
+    std::vector<std::uint64_t> slots(positive);
+    normalize_slots(slots);
+    LongArith result;
+    result.storage = slots_to_digits(slots);
+    slots.assign(negative.begin(), negative.end());
+    normalize_slots(slots);
+    const container_type negative_digits = slots_to_digits(slots);
+
+    if (compare_absolute_vectors(result.storage, negative_digits) > 0)
+    {
+        container_type difference(negative_digits);
+        substract_array(difference, result.storage);
+        result.storage = std::move(difference);
+        result.set_negative(true);
+    }
+    else
+    {
+        substract_array(result.storage, negative_digits);
+    }
+    result.check_zero();
+    return result;
+}
+
+void LongAccumulator::clear() noexcept
+{
+    positive.clear();
+    negative.clear();
+    pending = 0;
+}
+
+LongArith LongArith::sum_of(const LongArith* const* values, const size_t count, const ExecutionPolicy policy)
+{
+    // Every part has own accumulator
+    // Every value has at least one digit, so count is used as measure of work without extra pass over values
+    const size_t parts = threads_for(policy, count);
+    const size_t part_size = count ? (count + parts - 1) / parts : 0;
+    std::vector<LongAccumulator> accumulators(parts);
+    parallel_for(parts, parts, [&](const size_t begin, const size_t end) {
+        for (size_t part = begin; part < end; ++part)
+        {
+            for (size_t i = part * part_size, last = std::min(count, i + part_size); i < last; ++i)
+                accumulators[part] += *values[i];
+        }
+    });
+    for (size_t part = 1; part < parts; ++part)
+        accumulators[0] += accumulators[part];
+    return accumulators[0].to_LongArith();
+}
+
+LongArith LongArith::dot_of(const LongArith* const* a, const LongArith* const* b, const size_t count, const ExecutionPolicy policy)
+{
+    const size_t parts = threads_for(policy, count);
+    const size_t part_size = count ? (count + parts - 1) / parts : 0;
+    std::vector<LongAccumulator> accumulators(parts);
+    parallel_for(parts, parts, [&](const size_t begin, const size_t end) {
+        for (size_t part = begin; part < end; ++part)
+        {
+            for (size_t i = part * part_size, last = std::min(count, i + part_size); i < last; ++i)
+                accumulators[part].add_product(*a[i], *b[i]);
+        }
+    });
+    for (size_t part = 1; part < parts; ++part)
+        accumulators[0] += accumulators[part];
+    return accumulators[0].to_LongArith();
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Concurrent counter
+
+// Deltas with smaller absolute value are added to shard by atomic addition
+constexpr long long CounterFastDeltaLimit = 1LL << 40;
+// Delta of shard is moved to its LongArith when its absolute value reaches this.
+// Overflow would need 2^22 threads adding at once after this point
+constexpr long long CounterSpillLimit = 1LL << 62;
+
+// Size of cache line, every shard starts at multiple of it
+constexpr size_t CounterShardAlignment = 64;
+
+// Own cache line for every shard, so threads don't share lines
+struct alignas(CounterShardAlignment) ConcurrentLongCounter::shard
+{
+    std::atomic<long long> delta;
+    std::mutex lock;
+    // Guarded by lock
+    LongArith spilled;
+
+    shard() : delta(0), lock(), spilled() {}
+};
+
+// Index of calling thread, shard is chosen by it
+static size_t counter_thread_slot()
+{
+    static std::atomic<size_t> next_slot(0);
+    thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+ConcurrentLongCounter::ConcurrentLongCounter(const size_t shards_count)
+    : shard_memory(nullptr), shards(nullptr), shard_count(shards_count ? shards_count : LongArith::ExecutionPolicy::parallel().thread_count())
+{
+    // new[] doesn't guarantee extended alignment before C++17, so shards are placed in raw memory aligned by hand
+    shard_memory = ::operator new(sizeof(shard) * shard_count + CounterShardAlignment - 1);
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(shard_memory);
+    shards = reinterpret_cast<shard*>((address + CounterShardAlignment - 1) / CounterShardAlignment * CounterShardAlignment);
+    for (size_t i = 0; i < shard_count; ++i)
+        new (shards + i) shard();
+}
+
+ConcurrentLongCounter::~ConcurrentLongCounter()
+{
+    for (size_t i = 0; i < shard_count; ++i)
+        shards[i].~shard();
+    ::operator delete(shard_memory);
+}
+
+void ConcurrentLongCounter::add(const long long delta)
+{
+    shard& current = shards[counter_thread_slot() % shard_count];
+    if (delta <= -CounterFastDeltaLimit || delta >= CounterFastDeltaLimit)
+    {
+        std::lock_guard<std::mutex> guard(current.lock);
+        current.spilled += delta;
+        return;
+    }
+    const long long updated = current.delta.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (updated > -CounterSpillLimit && updated < CounterSpillLimit)
+        return;
+    // Delta is moved under lock, so load sees it either in delta or in spilled
+    std::lock_guard<std::mutex> guard(current.lock);
+    current.spilled += current.delta.exchange(0, std::memory_order_relaxed);
+}
+
+void ConcurrentLongCounter::add(const LongArith& delta)
+{
+    shard& current = shards[counter_thread_slot() % shard_count];
+    std::lock_guard<std::mutex> guard(current.lock);
+    current.spilled += delta;
+}
+
+LongArith ConcurrentLongCounter::load() const
+{
+    LongAccumulator total;
+    for (size_t i = 0; i < shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> guard(shards[i].lock);
+        total += shards[i].spilled;
+        total += shards[i].delta.load(std::memory_order_relaxed);
+    }
+    return total.to_LongArith();
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Batch container
+
+// Writes |a| + |b| to out, out must have max(a.size(), b.size()) + 1 digits
+// \return count of digits of result
+template<typename Left, typename Right>
+static size_t add_absolute_to(const Left& a, const Right& b, digit_t* out)
+{
+    const size_t a_size = a.size(), b_size = b.size();
+    size_t size = std::max(a_size, b_size);
+    compute_t carry = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        carry += (i < a_size ? a[i] : 0);
+        carry += (i < b_size ? b[i] : 0);
+        out[i] = TO_DIGIT_T(carry % DigitBase);
+        carry /= DigitBase;
+    }
+    if (carry)
+        out[size++] = TO_DIGIT_T(carry);
+    return size;
+}
+
+// Writes |bigger| - |less| to out, |bigger| >= |less|, out must have bigger.size() digits
+// \return count of digits of result without leading zeros
+template<typename Bigger, typename Less>
+static size_t substract_absolute_to(const Bigger& bigger, const Less& less, digit_t* out)
+{
+    const size_t bigger_size = bigger.size(), less_size = less.size();
+    compute_t borrow = 0;
+    for (size_t i = 0; i < bigger_size; ++i)
+    {
+        compute_t digit = TO_COMPUTE_T(bigger[i]) - borrow - (i < less_size ? less[i] : 0);
+        borrow = digit < 0;
+        if (borrow)
+            digit += DigitBase;
+        out[i] = TO_DIGIT_T(digit);
+    }
+    size_t size = bigger_size;
+    while (size > 1 && !out[size - 1])
+        --size;
+    return size;
+}
+
+size_t LongArithVector::digits_of(const LongArith& value) noexcept
+{
+    return value.storage.size();
+}
+
+LongArith LongArithVector::make_value(const digit_t* value_digits, const size_t count, const bool value_negative)
+{
+    LongArith result;
+    result.storage = container_type(value_digits, value_digits + count);
+    result.set_negative(value_negative);
+    return result;
+}
+
+LongArith LongArithVector::ElementView::to_LongArith() const
+{
+    return make_value(digits, digit_count, is_negative);
+}
+
+LongArithVector::LongArithVector()
+    : digits(), offsets(1, 0), negative()
+{
+}
+
+void LongArithVector::reserve(const size_t values, const size_t total_digits)
+{
+    digits.reserve(total_digits);
+    offsets.reserve(values + 1);
+    negative.reserve(values);
+}
+
+void LongArithVector::clear()
+{
+    digits.clear();
+    offsets.resize(1);
+    negative.clear();
+}
+
+void LongArithVector::push_back(const LongArith& value)
+{
+    digits.insert(digits.end(), value.storage.begin(), value.storage.end());
+    offsets.push_back(digits.size());
+    negative.push_back(value.get_negative());
+}
+
+void LongArithVector::add(const LongArithVector& other)
+{
+    if (other.size() != size())
+        throw std::invalid_argument("Vectors have different sizes");
+
+    // Every sum is not longer than sum of lengths of operands plus one digit
+    std::vector<digit_t> result_digits(digits.size() + other.digits.size() + size());
+    std::vector<size_t> result_offsets;
+    result_offsets.reserve(offsets.size());
+    result_offsets.push_back(0);
+    size_t position = 0;
+    for (size_t i = 0, count = size(); i < count; ++i)
+    {
+        const ElementView a = (*this)[i], b = other[i];
+        digit_t* out = result_digits.data() + position;
+        size_t result_size;
+        bool result_negative;
+        if (a.negative() == b.negative())
+        {
+            result_size = add_absolute_to(a, b, out);
+            result_negative = a.negative();
+        }
+        else if (compare_absolute_vectors(a, b) <= 0)
+        {
+            result_size = substract_absolute_to(a, b, out);
+            result_negative = a.negative();
+        }
+        else
+        {
+            result_size = substract_absolute_to(b, a, out);
+            result_negative = b.negative();
+        }
+        negative[i] = result_negative && !(result_size == 1 && !out[0]);
+        position += result_size;
+        result_offsets.push_back(position);
+    }
+    result_digits.resize(position);
+    digits.swap(result_digits);
+    offsets.swap(result_offsets);
+}
+
+void LongArithVector::multiply(const long long multiplier)
+{
+    const bool multiplier_negative = LongArith::native_negative(multiplier);
+    digit_t multiplier_digits[LongArith::NativeDigitCount];
+    const size_t multiplier_size = split_native(LongArith::native_magnitude(multiplier), multiplier_digits);
+
+    // Zero filled, as mult_basecase needs
+    std::vector<digit_t> result_digits(digits.size() + size() * multiplier_size);
+    std::vector<size_t> result_offsets;
+    result_offsets.reserve(offsets.size());
+    result_offsets.push_back(0);
+    size_t position = 0;
+    for (size_t i = 0, count = size(); i < count; ++i)
+    {
+        const ElementView a = (*this)[i];
+        digit_t* out = result_digits.data() + position;
+        mult_basecase(a.digits, a.size(), multiplier_digits, multiplier_size, out);
+        size_t result_size = a.size() + multiplier_size;
+        while (result_size > 1 && !out[result_size - 1])
+            --result_size;
+        negative[i] = (a.negative() != multiplier_negative) && !(result_size == 1 && !out[0]);
+        position += result_size;
+        result_offsets.push_back(position);
+    }
+    result_digits.resize(position);
+    digits.swap(result_digits);
+    offsets.swap(result_offsets);
+}
+
+int LongArithVector::compare(const size_t left, const size_t right) const noexcept
+{
+    const ElementView a = (*this)[left], b = (*this)[right];
+    if (a.negative() != b.negative())
+        return a.negative() ? -1 : 1;
+    // compare_absolute_vectors returns 1 if left is less
+    const int absolute = -compare_absolute_vectors(a, b);
+    return a.negative() ? -absolute : absolute;
+}
+
+void LongArithVector::sort()
+{
+    std::vector<size_t> order(size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](const size_t left, const size_t right) {
+        return compare(left, right) < 0;
+    });
+
+    std::vector<digit_t> result_digits;
+    result_digits.reserve(digits.size());
+    std::vector<size_t> result_offsets;
+    result_offsets.reserve(offsets.size());
+    result_offsets.push_back(0);
+    std::vector<unsigned char> result_negative;
+    result_negative.reserve(negative.size());
+    for (const size_t index : order)
+    {
+        result_digits.insert(result_digits.end(), digits.begin() + offsets[index], digits.begin() + offsets[index + 1]);
+        result_offsets.push_back(result_digits.size());
+        result_negative.push_back(negative[index]);
+    }
+    digits.swap(result_digits);
+    offsets.swap(result_offsets);
+    negative.swap(result_negative);
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Remainders
+
+// Count of moduli which share one pass over digits
+constexpr size_t RemainderBlockSize = 8;
+
+// (remainder * DigitBase + digit) % modulus for remainder < modulus
+template<bool SmallModulus>
+static inline std::uint64_t shift_remainder(const std::uint64_t remainder, const digit_t digit, const std::uint64_t modulus)
+{
+    if (SmallModulus) // remainder < 2^32, so product fits in 64 bits
+        return (remainder * DigitBase + digit) % modulus;
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>((static_cast<unsigned __int128>(remainder) * DigitBase + digit) % modulus);
+#else
+    // Multiplication by DigitBase bit by bit, every step stays below modulus
+    std::uint64_t result = 0, addition = remainder;
+    for (std::uint64_t factor = DigitBase; factor; factor >>= 1)
+    {
+        if (factor & 1)
+            result = (result >= modulus - addition) ? result - (modulus - addition) : result + addition;
+        addition = (addition >= modulus - addition) ? addition - (modulus - addition) : addition + addition;
+    }
+    const std::uint64_t reduced_digit = digit % modulus;
+    return (result >= modulus - reduced_digit) ? result - (modulus - reduced_digit) : result + reduced_digit;
+#endif
+}
+
+// Remainders by up to RemainderBlockSize moduli in one pass from most significant digit
+// Accumulators are independent, so their divisions run in parallel in CPU pipeline
+template<bool SmallModulus>
+static void remainders_block(const digit_t* digits, const size_t size, const std::uint64_t* moduli, const size_t count, std::uint64_t* output)
+{
+    LA_ASSERT(count <= RemainderBlockSize);
+    std::uint64_t accumulators[RemainderBlockSize] = {};
+    for (size_t i = size; i-- > 0;)
+    {
+        const digit_t digit = digits[i];
+        for (size_t k = 0; k < count; ++k)
+            accumulators[k] = shift_remainder<SmallModulus>(accumulators[k], digit, moduli[k]);
+    }
+    std::copy(accumulators, accumulators + count, output);
+}
+
+void LongArith::remainders(const LongArith& x, const std::uint64_t* moduli, const size_t count, std::uint64_t* output, const ExecutionPolicy policy)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!moduli[i])
+            throw std::logic_error("Division by zero");
+    }
+    const digit_t* digits = x.storage.begin();
+    const size_t size = x.storage.size();
+    const size_t blocks = (count + RemainderBlockSize - 1) / RemainderBlockSize;
+    parallel_for(blocks, threads_for(policy, size * blocks), [&](const size_t begin, const size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t first = block * RemainderBlockSize;
+            const size_t block_count = std::min(RemainderBlockSize, count - first);
+            const bool small = std::all_of(moduli + first, moduli + first + block_count,
+                [](const std::uint64_t modulus) { return modulus <= std::numeric_limits<std::uint32_t>::max(); });
+            if (small)
+                remainders_block<true>(digits, size, moduli + first, block_count, output + first);
+            else
+                remainders_block<false>(digits, size, moduli + first, block_count, output + first);
+        }
+    });
+}
+
+std::vector<std::uint64_t> LongArith::remainders(const LongArith& x, const std::vector<std::uint64_t>& moduli, const ExecutionPolicy policy)
+{
+    std::vector<std::uint64_t> result(moduli.size());
+    remainders(x, moduli.data(), moduli.size(), result.data(), policy);
+    return result;
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Products
+
+// Ranges with not more values are multiplied by loop
+constexpr size_t ProductTreeLeafSize = 16;
+// Binomial with k < n / BinomialSieveRatio is computed without prime sieve
+constexpr unsigned long long BinomialSieveRatio = 64;
+
+// Product of values with indexes in [begin, end) by balanced tree
+// leaf(begin, end) multiplies short ranges. Two halves of range run in separate threads while threads are left,
+// product of halves gets all threads of range
+template<typename Leaf>
+static LongArith product_tree(const size_t begin, const size_t end, const Leaf& leaf, const size_t threads)
+{
+    if (end - begin <= ProductTreeLeafSize)
+        return leaf(begin, end);
+    const size_t middle = begin + (end - begin) / 2;
+    LongArith left, right;
+    if (threads > 1)
+    {
+        // Halves are parts of parallel_for, so its exception handling and joining cover them
+        parallel_for(2, 2, [&](const size_t half, const size_t)
+        {
+            if (half == 0)
+                left = product_tree(begin, middle, leaf, threads / 2);
+            else
+                right = product_tree(middle, end, leaf, threads - threads / 2);
+        });
+    }
+    else
+    {
+        left = product_tree(begin, middle, leaf, 1);
+        right = product_tree(middle, end, leaf, 1);
+    }
+    return LongArith::multiply(left, right, LongArith::ExecutionPolicy::parallel(threads));
+}
+
+// Product of native values by balanced tree
+// Leaves pack values into native_uint_t while product fits, so LongArith is multiplied by one digit at once
+template<typename Value>
+static LongArith native_product_tree(const size_t count, const Value& value, const size_t threads)
+{
+    typedef LongArith::native_uint_t native_uint_t;
+    auto leaf = [&value](const size_t begin, const size_t end) {
+        LongArith result(1);
+        native_uint_t packed = 1;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const native_uint_t current = value(i);
+            if (packed > std::numeric_limits<native_uint_t>::max() / current)
+            {
+                result *= packed;
+                packed = 1;
+            }
+            packed *= current;
+        }
+        result *= packed;
+        return result;
+    };
+    return product_tree(0, count, leaf, threads);
+}
+
+// Primes which are not bigger than n by sieve of Eratosthenes
+static std::vector<unsigned long long> primes_up_to(const unsigned long long n)
+{
+    std::vector<unsigned long long> primes;
+    if (n < 2)
+        return primes;
+    std::vector<bool> composite(static_cast<size_t>(n + 1));
+    for (unsigned long long i = 2; i <= n; ++i)
+    {
+        if (composite[static_cast<size_t>(i)])
+            continue;
+        primes.push_back(i);
+        for (unsigned long long j = i * i; i <= n / i && j <= n; j += i)
+            composite[static_cast<size_t>(j)] = true;
+    }
+    return primes;
+}
+
+LongArith LongArith::product_of(const LongArith* const* values, const size_t count, const ExecutionPolicy policy)
+{
+    size_t total_digits = 0;
+    for (size_t i = 0; i < count; ++i)
+        total_digits += values[i]->storage.size();
+    auto leaf = [values](const size_t begin, const size_t end) {
+        LongArith result(1);
+        for (size_t i = begin; i < end; ++i)
+            result *= *values[i];
+        return result;
+    };
+    return product_tree(0, count, leaf, threads_for(policy, total_digits));
+}
+
+LongArith LongArith::factorial(const unsigned long long n, const ExecutionPolicy policy)
+{
+    if (n < 2)
+        return LongArith(1);
+    // Values are 2..n
+    const size_t count = static_cast<size_t>(n - 1);
+    return native_product_tree(count, [](const size_t i) { return native_uint_t(i + 2); }, threads_for(policy, count));
+}
+
+LongArith LongArith::binomial(const unsigned long long n, unsigned long long k, const ExecutionPolicy policy)
+{
+    if (k > n)
+        return LongArith(0);
+    k = std::min(k, n - k);
+    if (k < n / BinomialSieveRatio)
+    {
+        // (n-k+1)...n / k!
+        const size_t count = static_cast<size_t>(k);
+        const LongArith numerator = native_product_tree(count, [n, k](const size_t i) { return native_uint_t(n - k + 1 + i); }, threads_for(policy, count));
+        return numerator.divexact(factorial(k, policy));
+    }
+
+    // Exponent of p in C(n, k) is count of carries when k and n-k are added in base p,
+    // so p^e <= n and every factor fits in native integer
+    std::vector<unsigned long long> factors = primes_up_to(n);
+    size_t used = 0;
+    for (const unsigned long long p : factors)
+    {
+        unsigned long long factor = 1;
+        for (unsigned long long power = p; ; power *= p)
+        {
+            if (n / power - k / power - (n - k) / power)
+                factor *= p;
+            if (power > n / p)
+                break;
+        }
+        if (factor > 1)
+            factors[used++] = factor;
+    }
+    return native_product_tree(used, [&factors](const size_t i) { return native_uint_t(factors[i]); }, threads_for(policy, used));
+}
+
+LongArith LongArith::primorial(const unsigned long long n, const ExecutionPolicy policy)
+{
+    const std::vector<unsigned long long> primes = primes_up_to(n);
+    return native_product_tree(primes.size(), [&primes](const size_t i) { return native_uint_t(primes[i]); }, threads_for(policy, primes.size()));
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Residue number system
+
+// One operation in channel is counted as several digit operations for threads_for
+constexpr size_t RnsChannelWork = 4;
+
+// Largest primes below 2^31 in descending order, prime of channel i is element i
+// Products of two residues fit in 64 bits
+static const std::vector<std::uint64_t>& rns_primes()
+{
+    static const std::vector<std::uint64_t> primes = []()
+    {
+        // Primes have density about 1/21 near 2^31, so range is wide enough for MaxChannels primes
+        const std::uint64_t top = std::uint64_t(1) << 31;
+        const std::uint64_t width = RnsLongArith::MaxChannels * 32;
+        const std::uint64_t bottom = top - width;
+        std::vector<bool> composite(static_cast<size_t>(width));
+        for (const unsigned long long p : primes_up_to(46341))
+        {
+            for (std::uint64_t j = (bottom + p - 1) / p * p; j < top; j += p)
+                composite[static_cast<size_t>(j - bottom)] = true;
+        }
+        std::vector<std::uint64_t> result;
+        result.reserve(RnsLongArith::MaxChannels);
+        for (std::uint64_t i = width; i-- > 0 && result.size() < RnsLongArith::MaxChannels;)
+        {
+            if (!composite[static_cast<size_t>(i)])
+                result.push_back(bottom + i);
+        }
+        LA_ASSERT(result.size() == RnsLongArith::MaxChannels);
+        return result;
+    }();
+    return primes;
+}
+
+// Inverse of value modulo prime by extended Euclidean algorithm, value is not divisible by prime
+static std::uint64_t inverse_modulo(const std::uint64_t value, const std::uint64_t prime)
+{
+    long long a = static_cast<long long>(value % prime), b = static_cast<long long>(prime);
+    long long x = 1, y = 0;
+    while (a)
+    {
+        const long long quotient = b / a;
+        std::swap(b, a);
+        a -= quotient * b;
+        std::swap(y, x);
+        x -= quotient * y;
+    }
+    return static_cast<std::uint64_t>(y < 0 ? y + static_cast<long long>(prime) : y);
+}
+
+// target[i] = operation(target[i], source[i], prime of channel i) for every channel
+template<typename Operation>
+static void rns_apply(std::vector<std::uint32_t>& target, const std::vector<std::uint32_t>& source,
+    const LongArith::ExecutionPolicy& policy, const Operation& operation)
+{
+    if (target.size() != source.size())
+        throw std::invalid_argument("RNS values have different count of channels");
+    const std::uint64_t* primes = rns_primes().data();
+    std::uint32_t* target_data = target.data();
+    const std::uint32_t* source_data = source.data();
+    parallel_for(target.size(), threads_for(policy, target.size() * RnsChannelWork), [&](const size_t begin, const size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+            target_data[i] = static_cast<std::uint32_t>(operation(target_data[i], source_data[i], primes[i]));
+    });
+}
+
+static std::uint64_t rns_add(const std::uint64_t a, const std::uint64_t b, const std::uint64_t prime)
+{
+    const std::uint64_t sum = a + b;
+    return sum >= prime ? sum - prime : sum;
+}
+
+static std::uint64_t rns_substract(const std::uint64_t a, const std::uint64_t b, const std::uint64_t prime)
+{
+    return a >= b ? a - b : a + prime - b;
+}
+
+static std::uint64_t rns_multiply(const std::uint64_t a, const std::uint64_t b, const std::uint64_t prime)
+{
+    return a * b % prime;
+}
+
+size_t RnsLongArith::channels_for(const size_t decimal_digits)
+{
+    // Every prime is greater than 2^30, log2(10) < 3.322, one bit is for sign
+    if (decimal_digits > MaxChannels * 30 / 3)
+        throw std::invalid_argument("Too many digits for RNS channels");
+    const size_t bits = (decimal_digits * 3322 + 999) / 1000 + 1;
+    const size_t channels = std::max<size_t>(1, (bits + 29) / 30);
+    if (channels > MaxChannels)
+        throw std::invalid_argument("Too many digits for RNS channels");
+    return channels;
+}
+
+RnsLongArith::RnsLongArith(const size_t channels)
+{
+    if (!channels || channels > MaxChannels)
+        throw std::invalid_argument("Incorrect count of RNS channels");
+    residues.assign(channels, 0);
+}
+
+RnsLongArith RnsLongArith::from(const LongArith& value, const size_t channels, const ExecutionPolicy policy)
+{
+    RnsLongArith result(channels);
+    const std::uint64_t* primes = rns_primes().data();
+    std::vector<std::uint64_t> magnitude(channels);
+    LongArith::remainders(value, primes, channels, magnitude.data(), policy);
+    const bool negative = value.sign() < 0;
+    for (size_t i = 0; i < channels; ++i)
+    {
+        const std::uint64_t residue = (negative && magnitude[i]) ? primes[i] - magnitude[i] : magnitude[i];
+        result.residues[i] = static_cast<std::uint32_t>(residue);
+    }
+    return result;
+}
+
+LongArith RnsLongArith::to_LongArith() const
+{
+    const std::uint64_t* primes = rns_primes().data();
+    const size_t count = residues.size();
+    // Garner algorithm: value = mixed[0] + mixed[1]*p0 + mixed[2]*p0*p1 + ..., mixed[j] < primes[j]
+    // partial[i] is known part of this sum modulo primes[i], prefix[i] is p0*...*p(j-1) modulo primes[i]
+    // Inner loop has independent iterations for every channel
+    std::vector<std::uint64_t> mixed(count), partial(count, 0), prefix(count, 1);
+    for (size_t j = 0; j < count; ++j)
+    {
+        const std::uint64_t prime = primes[j];
+        const std::uint64_t difference = rns_substract(residues[j], partial[j], prime);
+        mixed[j] = difference * inverse_modulo(prefix[j], prime) % prime;
+        for (size_t i = j + 1; i < count; ++i)
+        {
+            partial[i] = (partial[i] + mixed[j] * prefix[i]) % primes[i];
+            prefix[i] = prefix[i] * prime % primes[i];
+        }
+    }
+
+    // (M-1)/2 has mixed digits (p-1)/2, so sign is found by comparison of digits from most significant
+    bool negative = false;
+    for (size_t j = count; j-- > 0;)
+    {
+        const std::uint64_t half = primes[j] / 2;
+        if (mixed[j] != half)
+        {
+            negative = mixed[j] > half;
+            break;
+        }
+    }
+    // M - 1 - value has mixed digits p - 1 - mixed, without borrows
+    if (negative)
+    {
+        for (size_t j = 0; j < count; ++j)
+            mixed[j] = primes[j] - 1 - mixed[j];
+    }
+
+    LongArith result;
+    for (size_t j = count; j-- > 0;)
+    {
+        result *= primes[j];
+        result += mixed[j];
+    }
+    if (negative)
+    {
+        ++result;
+        return -std::move(result);
+    }
+    return result;
+}
+
+RnsLongArith RnsLongArith::add(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy)
+{
+    RnsLongArith result(a);
+    rns_apply(result.residues, b.residues, policy, rns_add);
+    return result;
+}
+
+RnsLongArith RnsLongArith::substract(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy)
+{
+    RnsLongArith result(a);
+    rns_apply(result.residues, b.residues, policy, rns_substract);
+    return result;
+}
+
+RnsLongArith RnsLongArith::multiply(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy)
+{
+    RnsLongArith result(a);
+    rns_apply(result.residues, b.residues, policy, rns_multiply);
+    return result;
+}
+
+RnsLongArith& RnsLongArith::operator+=(const RnsLongArith& other)
+{
+    rns_apply(residues, other.residues, ExecutionPolicy::sequential(), rns_add);
+    return *this;
+}
+
+RnsLongArith& RnsLongArith::operator-=(const RnsLongArith& other)
+{
+    rns_apply(residues, other.residues, ExecutionPolicy::sequential(), rns_substract);
+    return *this;
+}
+
+RnsLongArith& RnsLongArith::operator*=(const RnsLongArith& other)
+{
+    rns_apply(residues, other.residues, ExecutionPolicy::sequential(), rns_multiply);
+    return *this;
+}
+
+RnsLongArith RnsLongArith::operator-() const
+{
+    RnsLongArith result(*this);
+    const std::uint64_t* primes = rns_primes().data();
+    for (size_t i = 0; i < residues.size(); ++i)
+        result.residues[i] = residues[i] ? static_cast<std::uint32_t>(primes[i] - residues[i]) : 0;
+    return result;
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Floating point conversion
+
+// Values with more digits are bigger than maximal double
+constexpr size_t DoubleMaxDigits = (std::numeric_limits<double>::max_exponent10 + DigitStringLength) / DigitStringLength;
+// 32-bit words enough for DoubleMaxDigits digits, every digit is less than 2^30
+constexpr size_t DoubleMaxWords = (DoubleMaxDigits * 30 + 31) / 32;
+
+static inline size_t bit_length(std::uint64_t value) noexcept
+{
+    size_t length = 0;
+    for (; value; value >>= 1)
+        ++length;
+    return length;
+}
+
+double LongArith::to_double() const noexcept
+{
+    if (plain_convertable())
+        return static_cast<double>(to_plain_int());
+    const double sign = get_negative() ? -1.0 : 1.0;
+    if (storage.size() > DoubleMaxDigits)
+        return sign * std::numeric_limits<double>::infinity();
+
+    // Value is short here, so it is converted to binary exactly
+    std::uint32_t words[DoubleMaxWords] = {};
+    size_t used = 0;
+    for (size_t i = storage.size(); i-- > 0;)
+    {
+        std::uint64_t carry = storage[i];
+        for (size_t w = 0; w < used; ++w)
+        {
+            const std::uint64_t current = static_cast<std::uint64_t>(words[w]) * DigitBase + carry;
+            words[w] = static_cast<std::uint32_t>(current);
+            carry = current >> 32;
+        }
+        for (; carry; carry >>= 32)
+            words[used++] = static_cast<std::uint32_t>(carry);
+    }
+    auto word = [&](const size_t index) -> std::uint64_t {
+        return index < used ? words[index] : 0;
+    };
+
+    const size_t bits = (used - 1) * 32 + bit_length(words[used - 1]);
+    if (bits <= 64)
+        return sign * static_cast<double>((word(1) << 32) | word(0));
+
+    // 64 most significant bits, lower bits only decide rounding
+    const size_t shift = bits - 64, low = shift / 32, offset = shift % 32;
+    std::uint64_t head = (word(low + 1) << 32) | word(low);
+    bool sticky = false;
+    if (offset)
+    {
+        head = (head >> offset) | (word(low + 2) << (64 - offset));
+        sticky = (words[low] & ((std::uint32_t(1) << offset) - 1)) != 0;
+    }
+    for (size_t w = 0; w < low && !sticky; ++w)
+        sticky = words[w] != 0;
+
+    // Round to 53 bits, ties to even. Carry to 2^53 is still exact
+    std::uint64_t mantissa = head >> 11;
+    const std::uint64_t rest = head & 0x7FF;
+    if (rest > 0x400 || (rest == 0x400 && (sticky || (mantissa & 1))))
+        ++mantissa;
+    return sign * std::ldexp(static_cast<double>(mantissa), static_cast<int>(shift + 11));
+}
+
+LongArith LongArith::from_double(const double value)
+{
+    if (!std::isfinite(value))
+        throw std::invalid_argument("Value is not finite");
+    const double magnitude = std::trunc(std::fabs(value));
+    LongArith result;
+    if (magnitude < 18446744073709551616.0) // 2^64
+    {
+        result = LongArith(static_cast<unsigned long long>(magnitude));
+    }
+    else
+    {
+        // Mantissa goes to 64 bits exactly, other bits of value are zero
+        int exponent = 0;
+        const double mantissa = std::frexp(magnitude, &exponent);
+        result = LongArith(static_cast<unsigned long long>(std::ldexp(mantissa, 64)));
+        int shift = exponent - 64;
+        for (; shift >= 29; shift -= 29)
+            result *= 1UL << 29;
+        if (shift)
+            result *= 1UL << shift;
+    }
+    result.set_negative(value < 0);
+    result.check_zero();
+    return result;
+}
+
+double LongArith::frexp(long long& exponent) const noexcept
+{
+    int small_exponent = 0;
+    const double value = to_double();
+    if (std::isfinite(value))
+    {
+        const double mantissa = std::frexp(std::fabs(value), &small_exponent);
+        exponent = small_exponent;
+        return mantissa;
+    }
+
+    // Three most significant digits multiplied by DigitBase^(size - 3),
+    // power is built by squaring with normalization after every step
+    const size_t size = storage.size();
+    const double top = (static_cast<double>(storage[size - 1]) * DigitBase + storage[size - 2]) * DigitBase + storage[size - 3];
+    double mantissa = std::frexp(top, &small_exponent);
+    exponent = small_exponent;
+    double power_mantissa = std::frexp(static_cast<double>(DigitBase), &small_exponent);
+    long long power_exponent = small_exponent;
+    for (size_t n = size - 3; n; n >>= 1)
+    {
+        if (n & 1)
+        {
+            mantissa = std::frexp(mantissa * power_mantissa, &small_exponent);
+            exponent += power_exponent + small_exponent;
+        }
+        power_mantissa = std::frexp(power_mantissa * power_mantissa, &small_exponent);
+        power_exponent = 2 * power_exponent + small_exponent;
+    }
+    return mantissa;
+}
+
+size_t LongArith::ilog10() const
+{
+    if (equals_zero())
+        throw std::logic_error("Logarithm of zero");
+    return (storage.size() - 1) * DigitStringLength + get_digit_count(storage.back()) - 1;
+}
+
+double LongArith::log() const
+{
+    if (get_negative() || equals_zero())
+        throw std::logic_error("Logarithm of non-positive value");
+    long long exponent = 0;
+    const double mantissa = frexp(exponent);
+    return std::log(mantissa) + static_cast<double>(exponent) * std::log(2.0);
+}
+
+double LongArith::log10() const
+{
+    if (get_negative() || equals_zero())
+        throw std::logic_error("Logarithm of non-positive value");
+    long long exponent = 0;
+    const double mantissa = frexp(exponent);
+    return std::log10(mantissa) + static_cast<double>(exponent) * std::log10(2.0);
+}
+
+
+#pragma endregion
+
+
+
+#pragma region Radix conversion
+
+// Values with at most this decimal length are converted to radix by repeated division by plain number
+constexpr size_t RadixBaseCaseLength = 400;
+
+static const char RadixSymbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// Value of symbol in radix up to 36 or -1
+static inline int radix_symbol_value(const char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Biggest power of radix which fits in one digit of DigitBase
+// \return the power, chars_per_chunk becomes its exponent
+static digit_t radix_chunk_base(const unsigned radix, size_t& chars_per_chunk)
+{
+    if (radix < 2 || radix > 36)
+        throw std::invalid_argument("Radix must be in [2, 36]");
+    digit_t chunk_base = radix;
+    chars_per_chunk = 1;
+    while (TO_COMPUTE_T(chunk_base) * radix <= DigitBase)
+    {
+        chunk_base *= radix;
+        ++chars_per_chunk;
+    }
+    return chunk_base;
+}
+
+// Powers of radix with fewer digits of DigitBase are divided by divmod, longer ones by Newton reciprocal
+constexpr size_t RadixNewtonMinDigits = 64;
+
+// Count of digits of DigitBase in x
+static size_t base_digit_count(const LongArith& x)
+{
+    return (x.decimal_digits() + DigitStringLength - 1) / DigitStringLength;
+}
+
+// Approximation of DigitBase^(2n)/divider, where n is count of digits of positive divider, error is few units
+// Reciprocal r of high h = n/2 + 3 digits of divider has about half of correct digits and one Newton step
+// r + r*(DigitBase^(2n) - divider*r)/DigitBase^(2n) doubles them. Difference in Newton step has about n/2
+// significant digits, so only high digits of it are multiplied by r of h digits
+// Complexity is O(n^1.58), it is about one multiplication of n digits
+static LongArith newton_reciprocal(const LongArith& divider)
+{
+    const size_t size = base_digit_count(divider);
+    LongArith scale(1);
+    if (size < RadixNewtonMinDigits)
+    {
+        scale.fast_multiply_by_10_inplace(2 * size * DigitStringLength);
+        return scale / divider;
+    }
+
+    // Reciprocal of high digits is approximation of DigitBase^(2n - low_size)/divider
+    const size_t low_size = size - (size / 2 + 3);
+    LongArith reciprocal = newton_reciprocal(divider.fast_divide_by_10(low_size * DigitStringLength));
+    scale.fast_multiply_by_10_inplace((2 * size - low_size) * DigitStringLength);
+    // Error of reciprocal can have any sign, so difference and correction are truncated toward zero.
+    // Truncated digits of difference change correction by less than one
+    LongArith difference = scale - divider * reciprocal;
+    difference.fast_divide_by_10_inplace((size - 2 - low_size) * DigitStringLength);
+    LongArith correction = reciprocal * difference;
+    correction.fast_divide_by_10_inplace((size + 2 - low_size) * DigitStringLength);
+    reciprocal.fast_multiply_by_10_inplace(low_size * DigitStringLength);
+    reciprocal += correction;
+    return reciprocal;
+}
+
+// Division of x in [0, divider^2) by positive divider with approximate reciprocal from newton_reciprocal
+// High digits of x multiplied by reciprocal give fraction with error of few units, remainder corrects it
+static void divide_by_reciprocal(const LongArith& x, const LongArith& divider, const LongArith& reciprocal,
+    LongArith& fraction, LongArith& remainder)
+{
+    const size_t size = base_digit_count(divider);
+    fraction = x.fast_divide_by_10((size - 1) * DigitStringLength) * reciprocal;
+    fraction.fast_divide_by_10_inplace((size + 1) * DigitStringLength);
+    remainder = x - fraction * divider;
+    while (remainder.sign() < 0)
+    {
+        remainder += divider;
+        --fraction;
+    }
+    while (!(remainder < divider))
+    {
+        remainder -= divider;
+        ++fraction;
+    }
+}
+
+// Appends symbols of absolute value of x which is less than powers[level - 1]^2 (or chunk base if level is 0)
+// \param powers[i] is chunk_base^(2^i)
+// \param reciprocals[i] is newton_reciprocal(powers[i]) or zero if powers[i] is divided by divmod
+// \param pad_length if not zero, result is padded by zeros to this length
+static void append_radix_symbols(const LongArith& x, const std::vector<LongArith>& powers, const std::vector<LongArith>& reciprocals,
+    size_t level, const unsigned radix, const size_t chars_per_chunk, const size_t pad_length, std::string& out)
+{
+    if (!level || x.decimal_length() <= RadixBaseCaseLength)
+    {
+        // Repeated division by chunk base, symbols are got from least significant
+        const digit_t chunk_base = static_cast<digit_t>(powers[0].to_plain_int());
+        std::string symbols;
+        LongArith rest(x);
+        long long chunk;
+        do
+        {
+            LongArith::divmod(rest, static_cast<long long>(chunk_base), rest, chunk);
+            for (size_t i = 0; i < chars_per_chunk; ++i)
+            {
+                symbols += RadixSymbols[chunk % radix];
+                chunk /= radix;
+            }
+        } while (!rest.equals_zero());
+        while (symbols.size() > 1 && symbols.back() == '0')
+            symbols.pop_back();
+        if (symbols.size() < pad_length)
+            out.append(pad_length - symbols.size(), '0');
+        out.append(symbols.rbegin(), symbols.rend());
+        return;
+    }
+
+    // x = high * powers[level-1] + low, low has exactly chars_per_chunk*2^(level-1) symbols
+    --level;
+    const size_t low_length = chars_per_chunk << level;
+    LongArith high, low;
+    if (reciprocals[level].equals_zero())
+        LongArith::divmod(x, powers[level], high, low);
+    else
+        divide_by_reciprocal(x, powers[level], reciprocals[level], high, low);
+    if (high.equals_zero())
+    {
+        append_radix_symbols(low, powers, reciprocals, level, radix, chars_per_chunk, pad_length, out);
+        return;
+    }
+    append_radix_symbols(high, powers, reciprocals, level, radix, chars_per_chunk, (pad_length > low_length) ? pad_length - low_length : 0, out);
+    append_radix_symbols(low, powers, reciprocals, level, radix, chars_per_chunk, low_length, out);
+}
+
+std::string LongArith::to_string_radix(const unsigned radix) const
+{
+    size_t chars_per_chunk;
+    const digit_t chunk_base = radix_chunk_base(radix, chars_per_chunk);
+    if (radix == 10)
+        return to_string();
+
+    LongArith abs_value(*this);
+    abs_value.set_negative(false);
+
+    // Cached powers chunk_base^(2^i) up to first one which square is surely bigger than value:
+    // square of number with n digits has at least 2n - 1 digits
+    const size_t value_size = base_digit_count(abs_value);
+    std::vector<LongArith> powers;
+    powers.push_back(LongArith(chunk_base));
+    while (2 * base_digit_count(powers.back()) - 1 <= value_size)
+        powers.push_back(powers.back() * powers.back());
+
+    // Every power is divider on own level of recursion, its reciprocal is computed once
+    std::vector<LongArith> reciprocals(powers.size());
+    for (size_t i = 0; i < powers.size(); ++i)
+        if (base_digit_count(powers[i]) >= RadixNewtonMinDigits)
+            reciprocals[i] = newton_reciprocal(powers[i]);
+
+    std::string res;
+    if (get_negative() && !equals_zero())
+        res += '-';
+    append_radix_symbols(abs_value, powers, reciprocals, powers.size(), radix, chars_per_chunk, 0, res);
+    return res;
+}
+
+LongArith LongArith::from_string_radix(const std::string& s, const unsigned radix)
+{
+    size_t chars_per_chunk;
+    const digit_t chunk_base = radix_chunk_base(radix, chars_per_chunk);
+    if (radix == 10)
+        return from_string(s);
+
+    // Same grammar as from_string: leading spaces and tabs, optional sign, symbols
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+    while (first != last && (*first == ' ' || *first == '\t'))
+        ++first;
+    bool negative = false;
+    if (first != last && (*first == '-' || *first == '+'))
+    {
+        negative = *first == '-';
+        ++first;
+    }
+    if (first == last)
+        throw std::invalid_argument("Invalid string");
+
+    // Chunks of chars_per_chunk symbols from least significant
+    const size_t length = last - first;
+    std::vector<LongArith> values;
+    values.reserve(length / chars_per_chunk + 1);
+    for (size_t end = length; end;)
+    {
+        const size_t begin = (end > chars_per_chunk) ? end - chars_per_chunk : 0;
+        digit_t chunk = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const int symbol = radix_symbol_value(first[i]);
+            if (symbol < 0 || static_cast<unsigned>(symbol) >= radix)
+                throw std::invalid_argument("Invalid string");
+            chunk = chunk * radix + static_cast<digit_t>(symbol);
+        }
+        values.push_back(LongArith(chunk));
+        end = begin;
+    }
+
+    // Pairs of neighbour values are joined by multiplication on cached power of radix,
+    // so every level halves count of values and doubles their length
+    LongArith power(chunk_base);
+    while (values.size() > 1)
+    {
+        const size_t pairs = values.size() / 2;
+        for (size_t j = 0; j < pairs; ++j)
+        {
+            LongArith& high = values[2 * j + 1];
+            high *= power;
+            high += values[2 * j];
+            values[j] = std::move(high);
+        }
+        if (values.size() % 2)
+            values[pairs] = std::move(values.back());
+        values.resize((values.size() + 1) / 2);
+        if (values.size() > 1)
+            power = power * power;
     }
+
+    LongArith result(std::move(values[0]));
+    result.set_negative(negative);
+    result.check_zero();
     return result;
 }
 
+#pragma endregion
+
+
+#pragma region Files
+
+// Read-only mapping of whole file, unmapped in destructor
+class mapped_file
+{
+public:
+    explicit mapped_file(const std::string& path)
+    {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Cannot open file");
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("Cannot get size of file");
+        }
+        size = static_cast<size_t>(file_size.QuadPart);
+        mapping = nullptr;
+        data = nullptr;
+        if (size)
+        {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+                data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!data)
+            {
+                if (mapping)
+                    CloseHandle(mapping);
+                CloseHandle(file);
+                throw std::runtime_error("Cannot map file");
+            }
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open file");
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Cannot get size of file");
+        }
+        size = static_cast<size_t>(info.st_size);
+        data = nullptr;
+        if (size)
+        {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                close(fd);
+                throw std::runtime_error("Cannot map file");
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapped);
+        }
+        close(fd); // mapping stays valid
+#endif
+    }
+
+    ~mapped_file()
+    {
+#if defined(_WIN32)
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        if (data)
+            munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const char* data;
+    size_t size;
+private:
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+static inline bool is_blank(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+LongArith LongArith::from_file(const std::string& path, const ExecutionPolicy policy)
+{
+    const mapped_file file(path);
+    const char* first = file.data;
+    const char* last = file.data + file.size;
+    // Files usually end with line break
+    while (first != last && is_blank(*first))
+        ++first;
+    while (last != first && is_blank(*(last - 1)))
+        --last;
+    return from_chars(policy, first, last);
+}
 
 #pragma endregion
 
 
+#pragma region Binary format
+
+// Bits of header byte
+constexpr unsigned char BinaryVersionMask = 0x0F;
+constexpr unsigned char BinaryVarintFlag = 0x40;
+constexpr unsigned char BinaryNegativeFlag = 0x80;
+constexpr size_t BinaryDigitSize = 4; // every digit is stored as 32-bit little-endian value
+constexpr size_t BinaryFixedLengthSize = 8; // digit count without varint is 64-bit little-endian value
+
+static_assert(DigitBase <= 0xFFFFFFFFLL, "Digits must fit in 32 bits");
+
+static inline void store_le32(unsigned char* out, const digit_t value)
+{
+    for (size_t i = 0; i < BinaryDigitSize; ++i)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static inline digit_t load_le32(const unsigned char* in)
+{
+    return static_cast<digit_t>(in[0]) | (static_cast<digit_t>(in[1]) << 8)
+        | (static_cast<digit_t>(in[2]) << 16) | (static_cast<digit_t>(in[3]) << 24);
+}
+
+// Length of digit count field
+static size_t length_field_size(uint64_t count, const bool varint_length)
+{
+    if (!varint_length)
+        return BinaryFixedLengthSize;
+    size_t bytes = 1;
+    while (count >= 0x80)
+    {
+        count >>= 7;
+        ++bytes;
+    }
+    return bytes;
+}
+
+// Reads header and digit count
+// \return offset of first digit
+static size_t read_binary_header(const unsigned char* data, const size_t size, bool& negative, size_t& count)
+{
+    if (!size || (data[0] & BinaryVersionMask) != LongArith::BinaryFormatVersion)
+        throw std::invalid_argument("Unknown binary format");
+    negative = (data[0] & BinaryNegativeFlag) != 0;
+    uint64_t value = 0;
+    size_t offset = 1;
+    if (data[0] & BinaryVarintFlag)
+    {
+        for (unsigned shift = 0;; shift += 7)
+        {
+            if (offset == size || shift >= 64)
+                throw std::invalid_argument("Broken digit count");
+            const unsigned char byte = data[offset++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+    }
+    else
+    {
+        if (size - offset < BinaryFixedLengthSize)
+            throw std::invalid_argument("Broken digit count");
+        for (size_t i = 0; i < BinaryFixedLengthSize; ++i)
+            value |= static_cast<uint64_t>(data[offset++]) << (8 * i);
+    }
+    if (!value || value > (size - offset) / BinaryDigitSize)
+        throw std::invalid_argument("Wrong digit count");
+    count = static_cast<size_t>(value);
+    // Most significant digit can be zero only in zero
+    if (count > 1 && !load_le32(data + offset + (count - 1) * BinaryDigitSize))
+        throw std::invalid_argument("Leading zero digit");
+    return offset;
+}
+
+size_t LongArith::serialized_size(const bool varint_length) const noexcept
+{
+    return 1 + length_field_size(storage.size(), varint_length) + storage.size() * BinaryDigitSize;
+}
+
+size_t LongArith::serialize(unsigned char* out, const bool varint_length) const
+{
+    unsigned char* position = out;
+    *position++ = BinaryFormatVersion | (varint_length ? BinaryVarintFlag : 0)
+        | ((get_negative() && !equals_zero()) ? BinaryNegativeFlag : 0);
+    uint64_t count = storage.size();
+    if (varint_length)
+    {
+        while (count >= 0x80)
+        {
+            *position++ = static_cast<unsigned char>(count | 0x80);
+            count >>= 7;
+        }
+        *position++ = static_cast<unsigned char>(count);
+    }
+    else
+    {
+        for (size_t i = 0; i < BinaryFixedLengthSize; ++i)
+            *position++ = static_cast<unsigned char>(count >> (8 * i));
+    }
+    for (size_t i = 0, storage_size = storage.size(); i < storage_size; ++i, position += BinaryDigitSize)
+        store_le32(position, storage[i]);
+    return position - out;
+}
+
+LongArith LongArith::deserialize(const unsigned char* data, const size_t size, size_t* consumed)
+{
+    bool negative;
+    size_t count;
+    const size_t offset = read_binary_header(data, size, negative, count);
+    LongArith result;
+    result.storage.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const digit_t digit = load_le32(data + offset + i * BinaryDigitSize);
+        if (digit >= DigitBase)
+            throw std::invalid_argument("Wrong digit");
+        result.storage[i] = digit;
+    }
+    result.set_negative(negative);
+    result.check_zero();
+    if (consumed)
+        *consumed = offset + count * BinaryDigitSize;
+    return result;
+}
+
+#if defined(LONGARITH_HAS_STD_BYTE)
+size_t LongArith::serialize(std::byte* out, const bool varint_length) const
+{
+    return serialize(reinterpret_cast<unsigned char*>(out), varint_length);
+}
+
+LongArith LongArith::deserialize(const std::byte* data, const size_t size, size_t* consumed)
+{
+    return deserialize(reinterpret_cast<const unsigned char*>(data), size, consumed);
+}
+#endif
+
+// View
+
+LongArithView::LongArithView(const unsigned char* data, const size_t size)
+{
+    size_t count;
+    const size_t offset = read_binary_header(data, size, is_negative, count);
+    digits = data + offset;
+    digit_count = count;
+    byte_size = offset + count * BinaryDigitSize;
+    if (equals_zero())
+        is_negative = false;
+}
+
+LongArithView::digit_t LongArithView::operator[](const size_t index) const noexcept
+{
+    return load_le32(digits + index * BinaryDigitSize);
+}
+
+bool LongArithView::equals_zero() const noexcept
+{
+    return digit_count == 1 && !(*this)[0];
+}
+
+LongArith LongArithView::to_LongArith() const
+{
+    LongArith result;
+    result.assign_view(*this, false);
+    return result;
+}
+
+void LongArith::assign_view(const LongArithView& view, const bool negate)
+{
+    const size_t view_size = view.size();
+    storage.resize(view_size);
+    for (size_t i = 0; i < view_size; ++i)
+        storage[i] = view[i];
+    set_negative(view.negative() != negate);
+    check_zero();
+}
+
+int LongArith::compare(const LongArith& left, const LongArithView& right)
+{
+    const bool left_negative = left.get_negative();
+    if (left_negative != right.negative())
+        return left_negative ? -1 : 1;
+    const int abs_cmp = -compare_absolute_vectors(left.storage, right); // 1 if |left| > |right|
+    return left_negative ? -abs_cmp : abs_cmp;
+}
+
+void LongArith::add_view(const LongArithView& change, const bool negate)
+{
+    const bool change_negative = change.negative() != negate;
+    if (get_negative() == change_negative)
+    {
+        unchecked_internal_add_array(storage, change, 0);
+    }
+    else if (compare_absolute_vectors(storage, change) <= 0)
+    {
+        substract_array(storage, change);
+    }
+    else
+    {
+        container_type tmp(storage);
+        assign_view(change, negate);
+        substract_array(storage, tmp);
+        set_negative(change_negative);
+    }
+    check_zero();
+}
+
+LongArith& LongArith::operator+=(const LongArithView& change)&
+{
+    add_view(change, false);
+    return *this;
+}
+
+LongArith& LongArith::operator-=(const LongArithView& change)&
+{
+    add_view(change, true);
+    return *this;
+}
+
+// Multiplication and division need contiguous digits, so view is decoded to buffer which keeps capacity between calls
+// while it is small. It is O(n) and much cheaper than operation itself
+LongArith& LongArith::operator*=(const LongArithView& multiplier)&
+{
+    static thread_local LongArith decoded;
+    decoded.assign_view(multiplier, false);
+    *this *= decoded;
+    release_big_scratch(decoded.storage);
+    return *this;
+}
+
+LongArith& LongArith::operator/=(const LongArithView& divider)&
+{
+    static thread_local LongArith decoded;
+    decoded.assign_view(divider, false);
+    *this /= decoded;
+    release_big_scratch(decoded.storage);
+    return *this;
+}
+
+LongArith& LongArith::operator%=(const LongArithView& divider)&
+{
+    static thread_local LongArith decoded;
+    decoded.assign_view(divider, false);
+    *this %= decoded;
+    release_big_scratch(decoded.storage);
+    return *this;
+}
+
+#pragma endregion
+
 
 #pragma region Definition of internal container
 
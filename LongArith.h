@@ -5,8 +5,26 @@ https://github.com/AngelicosPhosphoros/LongArithmeticsCPP/
 
 #pragma once
 #include <ostream>
+#include <istream>
 #include <algorithm>
 #include <type_traits>
+#include <limits>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <iterator>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#include <cstddef>
+#define LONGARITH_HAS_STRING_VIEW
+#define LONGARITH_HAS_STD_BYTE
+#endif
+
+class LongArithView;
+class LongAccumulator;
+class LongArithVector;
 
 
 class LongArith
@@ -31,6 +49,59 @@ public:
 	static_assert(std::is_integral<digit_t>::value && std::is_integral<compute_t>::value, "compute_t and digit_t must be integral types");
 	static_assert(std::is_signed<compute_t>::value, "compute_t must be signed");
 
+	// Widest native unsigned integer. Mixed-type operations work with absolute value in it
+#if defined(__SIZEOF_INT128__)
+	typedef unsigned __int128 native_uint_t;
+#else
+	typedef unsigned long long native_uint_t;
+#endif
+	// how many digits we need to store any native_uint_t value
+	static constexpr size_t NativeDigitCount = (sizeof(native_uint_t) > 8) ? 5 : 3;
+
+	// true for integer types which can be used in mixed-type operations
+	template<typename T>
+	struct is_native_integer : std::integral_constant<bool,
+		(std::is_integral<T>::value && !std::is_same<T, bool>::value)
+#if defined(__SIZEOF_INT128__)
+		|| std::is_same<T, __int128>::value || std::is_same<T, unsigned __int128>::value
+#endif
+	> {};
+
+	template<typename T>
+	struct is_native_signed : std::integral_constant<bool, std::is_signed<T>::value
+#if defined(__SIZEOF_INT128__)
+		|| std::is_same<T, __int128>::value
+#endif
+	> {};
+
+	template<typename T>
+	using enable_if_native_t = typename std::enable_if<is_native_integer<T>::value>::type;
+
+	// Type of remainder of division by Int. Remainder has sign of dividable, so for unsigned Int it is LongArith:
+	// remainder of negative dividable doesn't fit in Int
+	template<typename Int>
+	using native_remainder_t = typename std::conditional<is_native_signed<Int>::value, Int, LongArith>::type;
+
+	// \brief How many threads operation can use
+	// \detailed Operations which accept it split work to parts and run them in separate threads.
+	//           Small arguments are processed by one thread anyway
+	class ExecutionPolicy
+	{
+	public:
+		// Run in calling thread
+		static ExecutionPolicy sequential() noexcept {
+			return ExecutionPolicy(1);
+		}
+		// Run in threads threads, 0 means all hardware threads
+		static ExecutionPolicy parallel(const size_t threads = 0) noexcept {
+			return ExecutionPolicy(threads);
+		}
+		size_t thread_count() const noexcept;
+	private:
+		explicit ExecutionPolicy(const size_t threads_count) noexcept : threads(threads_count) {}
+		size_t threads;
+	};
+
 private:
 
 	// getters and setters
@@ -54,6 +125,72 @@ private:
 	// Complexity: if they has differen sizes - const; otherwise O(n)
 	static signed short compare_absolute_values(const LongArith &left, const LongArith &rigth);
 
+	friend class LongArithView;
+	friend class LongAccumulator;
+	friend class LongArithVector;
+
+	// Copies digits of view into storage
+	void assign_view(const LongArithView& view, const bool negate);
+	// this += (negate ? -change : change)
+	void add_view(const LongArithView& change, const bool negate);
+
+	// Pointers to values of range, so batch operations can split it to parts
+	template<typename Iter>
+	static std::vector<const LongArith*> collect_values(Iter first, Iter last) {
+		std::vector<const LongArith*> values;
+		// Input iterators can be passed only once
+		if (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iter>::iterator_category>::value)
+			values.reserve(static_cast<size_t>(std::distance(first, last)));
+		for (; first != last; ++first)
+			values.push_back(&*first);
+		return values;
+	}
+
+	// Product of *values[0] ... *values[count - 1] by balanced tree
+	static LongArith product_of(const LongArith* const* values, const size_t count, const ExecutionPolicy policy);
+
+	// Sum of *values[0] ... *values[count - 1] with lazy carries
+	static LongArith sum_of(const LongArith* const* values, const size_t count, const ExecutionPolicy policy);
+	// Sum of *a[i] * *b[i] for i in [0, count)
+	static LongArith dot_of(const LongArith* const* a, const LongArith* const* b, const size_t count, const ExecutionPolicy policy);
+
+	// Parser of from_chars. Reuses memory of result
+	// \return false if string is not correct, result is unspecified then
+	static bool parse_chars(const char* first, const char* last, LongArith& result, const ExecutionPolicy policy);
+
+	// Split native integer to sign and absolute value
+	template<typename Int>
+	static constexpr bool native_negative(const Int value) noexcept
+	{
+		return is_native_signed<Int>::value && value < Int(0);
+	}
+	template<typename Int>
+	static constexpr native_uint_t native_magnitude(const Int value) noexcept
+	{
+		// conversion of negative value to unsigned is modular so it works for min() too
+		return native_negative(value) ? native_uint_t(0) - static_cast<native_uint_t>(value) : static_cast<native_uint_t>(value);
+	}
+
+	// Kernels of mixed-type operations. Native value is split to digits on stack, no allocations.
+	void assign_native(const bool negative, const native_uint_t magnitude);
+	void add_native(const bool negative, const native_uint_t magnitude);
+	void mult_native(const bool negative, const native_uint_t magnitude);
+	LongArith divexact_native(const bool negative, const native_uint_t magnitude) const;
+	// Writes remainder with given sign and absolute value
+	template<typename Int>
+	static void assign_remainder(Int& remainder, const bool negative, const native_uint_t magnitude) noexcept
+	{
+		remainder = negative ? static_cast<Int>(native_uint_t(0) - magnitude) : static_cast<Int>(magnitude);
+	}
+	static void assign_remainder(LongArith& remainder, const bool negative, const native_uint_t magnitude)
+	{
+		remainder.assign_native(negative, magnitude);
+	}
+
+	// Puts |dividable| / divider into fraction and returns |dividable| % divider
+	// fraction can be same object as dividable
+	static native_uint_t divide_native(const LongArith& dividable, const native_uint_t divider, LongArith& fraction);
+
 
 public:
 
@@ -66,8 +203,12 @@ public:
 	// Constructor. Initiate with zero
 	LongArith();
 
-	// With initial value
-	LongArith(long default_value);
+	// With initial value. Accepts any native integer including 64 and 128-bit
+	template<typename Int, typename = enable_if_native_t<Int>>
+	LongArith(const Int default_value) : storage()
+	{
+		assign_native(native_negative(default_value), native_magnitude(default_value));
+	}
 
 	LongArith(const LongArith &original) = default;
 
@@ -75,13 +216,118 @@ public:
 
 
 	// \brief Converts string in decimal format
-	std::string to_string() const;
+	std::string to_string() const {
+		return to_string(ExecutionPolicy::sequential());
+	}
+
+	// \brief Converts string in decimal format by several threads
+	// \detailed Digits map to independent blocks of DigitStringLength characters,
+	//           so parts of them are written to one preallocated string in parallel.
+	//           Small values are converted by one thread anyway
+	std::string to_string(const ExecutionPolicy policy) const;
+
+	// \brief Writes decimal representation to [first, last) without allocation of memory
+	// \detailed Every digit of DigitBase is printed by pairs of characters from lookup table.
+	//           Doesn't write terminating zero
+	// \return Pointer after last written character or nullptr if buffer is shorter than decimal_length()
+	char* to_chars(char* first, char* last) const;
+
+	// \brief Generator of decimal representation by chunks starting from most significant characters
+	// \detailed Uses same formatting as to_string but keeps only position, so memory usage doesn't depend on
+	//           size of number. Number must not be changed while generator is used
+	class DecimalChunks
+	{
+	public:
+		explicit DecimalChunks(const LongArith& value) noexcept;
+		// \brief Writes next characters, no more than size
+		// \return count of written characters, 0 when all characters are written
+		size_t read(char* out, const size_t size);
+		// count of characters which are not written yet
+		inline size_t remaining() const noexcept {
+			return length - position;
+		}
+	private:
+		const LongArith* number;
+		size_t position;
+		size_t length;
+	};
+
+	// \brief Passes decimal representation to callback by chunks of chunk_size characters (last can be shorter)
+	// \param callback is called as callback(const char* data, size_t size) and returns false to stop
+	// \return false if callback stopped export
+	template<typename Callback>
+	bool for_each_decimal_chunk(const size_t chunk_size, Callback callback) const
+	{
+		std::string buffer(std::max<size_t>(chunk_size, 1), '\0');
+		DecimalChunks chunks(*this);
+		for (size_t size; (size = chunks.read(&buffer[0], buffer.size())) != 0;)
+		{
+			if (!callback(static_cast<const char*>(&buffer[0]), size))
+				return false;
+		}
+		return true;
+	}
+
+	// \brief Writes decimal representation to file descriptor by chunks, full string is never built
+	// \return true if all characters are written
+	bool write_to_fd(const int fd) const;
+
+	// \brief Exact count of characters of decimal representation including minus
+	//         Complexity is O(1)
+	size_t decimal_length() const noexcept;
 
 	// \brief Builds long number from decimal string
 	// \detailed Builds long number from string, which can begin from '-'
 	//           or '+' and can contain only decimal symbols
 	static LongArith from_string(const std::string& s);
 
+	// \brief Builds long number from decimal string by several threads
+	// \detailed Blocks of DigitStringLength characters are checked and parsed in parallel
+	static LongArith from_string(const ExecutionPolicy policy, const std::string& s);
+
+	// \brief Builds long number from decimal characters in [first, last)
+	// \detailed Characters are checked and parsed in one pass, 8 characters per step by SWAR,
+	//           digits are written directly into storage. Accepts '-' or '+' at beginning and decimal symbols only.
+	//           Throws std::invalid_argument if string is not correct
+	static LongArith from_chars(const char* first, const char* last);
+	static LongArith from_chars(const ExecutionPolicy policy, const char* first, const char* last);
+
+#if defined(LONGARITH_HAS_STRING_VIEW)
+	static LongArith from_chars(const std::string_view s);
+
+	// \brief Parses many decimal strings in several threads
+	// \detailed Values are parsed straight into output[i] reusing its memory. Incorrect strings don't throw:
+	//           valid[i] becomes false and output[i] becomes 0.
+	//           std::bad_alloc (or std::system_error if thread can't be started) is propagated after all threads finish,
+	//           output and valid are partially written then
+	// \param valid - array of count flags or nullptr
+	// \return count of incorrect strings
+	static size_t from_strings(const std::string_view* strings, const size_t count, LongArith* output, bool* valid,
+		const ExecutionPolicy policy = ExecutionPolicy::parallel());
+	// \brief Same as previous, values are appended to arena of output
+	// \detailed If std::bad_alloc or std::system_error is propagated, output keeps its previous elements
+	static size_t from_strings(const std::string_view* strings, const size_t count, LongArithVector& output, bool* valid,
+		const ExecutionPolicy policy = ExecutionPolicy::parallel());
+#endif
+
+	// \brief Converts to string in radix from 2 to 36
+	// \detailed Symbols are 0-9 and a-z. Value is recursively split by cached powers radix^(k*2^i).
+	//           Long powers are divided by multiplication on their Newton reciprocals, so complexity is O(n^1.58)
+	std::string to_string_radix(const unsigned radix) const;
+
+	// \brief Builds long number from string in radix from 2 to 36
+	// \detailed Grammar is same as in from_string: leading spaces and tabs are skipped, then optional '-' or '+',
+	//           then symbols 0-9, a-z and A-Z. Chunks of symbols are joined pairwise by multiplication
+	//           on cached powers of radix. Multiplication is Karatsuba, so complexity is O(n^1.58).
+	//           Throws std::invalid_argument if string is not correct
+	static LongArith from_string_radix(const std::string& s, const unsigned radix);
+
+	// \brief Reads long number from file with decimal string
+	// \detailed File is mapped to memory and parsed in place, so it is not copied to string.
+	//           Blanks at beginning and end are skipped. Large files are parsed by several threads.
+	//           Throws std::runtime_error if file cannot be read and std::invalid_argument if it is not correct
+	static LongArith from_file(const std::string& path, const ExecutionPolicy policy = ExecutionPolicy::parallel());
+
 	// \brief Returns sign of number
 	// \return Returns -1, if negative; 0, if 0; 1 if positive
 	// \detailed Calculate sign of number.
@@ -90,7 +336,7 @@ public:
 
 	// \brief Divide dividend by divider, returns fraction and remainder
 	// \detailed This function is provided to use in cases when user need both division and modulus results
-	//              it calculate it with complexity O(m*n*log(DigitBase)) in worst case
+	//              it calculate it with complexity O(m*n)
 	// \return Pair of fraction (first) and remainder (second)
 	static std::pair<LongArith, LongArith> fraction_and_remainder(const LongArith& dividable, const LongArith& divider);
 
@@ -98,19 +344,210 @@ public:
 	// \detailed This function is provided to use in cases when user need both division and modulus results when divider is plain number
 	//           It works significantly faster than version that get LongArith divider
 	//           Complexity of method is O(n)
+	//           Remainder has sign of dividable, so fraction*divider + remainder == dividable.
+	//           Remainder is Int for signed divider and LongArith for unsigned one
 	// \return Pair of fraction (first) and remainder (second)
-	static std::pair<LongArith, long> fraction_and_remainder(const LongArith& dividable, const long divider);
+	template<typename Int, typename = enable_if_native_t<Int>>
+	static std::pair<LongArith, native_remainder_t<Int>> fraction_and_remainder(const LongArith& dividable, const Int divider)
+	{
+		std::pair<LongArith, native_remainder_t<Int>> result;
+		divmod(dividable, divider, result.first, result.second);
+		return result;
+	}
+
+	// \brief Divide dividend by divider and write fraction and remainder into existing objects
+	// \detailed Same as fraction_and_remainder, but reuses memory of fraction and remainder,
+	//           so loop of divisions into same variables doesn't allocate memory.
+	//           Fraction or remainder can be same object as dividable or divider, but not same object as each other
+	static void divmod(const LongArith& dividable, const LongArith& divider, LongArith& fraction, LongArith& remainder);
+
+	template<typename Int, typename = enable_if_native_t<Int>>
+	static void divmod(const LongArith& dividable, const Int divider, LongArith& fraction, native_remainder_t<Int>& remainder)
+	{
+		const bool dividable_negative = dividable.get_negative();
+		const native_uint_t abs_remainder = divide_native(dividable, native_magnitude(divider), fraction);
+		fraction.set_negative(native_negative(divider) != dividable_negative);
+		fraction.check_zero();
+		assign_remainder(remainder, dividable_negative, abs_remainder);
+	}
+
+	// \brief Divide value by divider which is known to divide it without remainder
+	// \detailed Uses exact division from least significant digit (Jebelean), so it doesn't
+	//           search digits of fraction like fraction_and_remainder does. Complexity is O(m*(n-m))
+	//           Result is undefined if remainder is not zero. Define LONGARITH_CHECK_DIVEXACT
+	//           to check it and throw std::logic_error
+	// \return value/divider
+	LongArith divexact(const LongArith& divider) const;
+
+	template<typename Int, typename = enable_if_native_t<Int>>
+	LongArith divexact(const Int divider) const {
+		return divexact_native(native_negative(divider), native_magnitude(divider));
+	}
+
+	// How quotient is rounded by division by power of 10
+	enum class RoundingMode
+	{
+		TowardZero,
+		HalfEven,
+		Ceil,
+		Floor
+	};
 
 	// \brief Divide value by 10^power
+	// \detailed Whole digits are dropped and the rest is shifted by one pass, complexity is O(len)
 	// \param power - exponent of 10
 	// \return value/10^power
-	LongArith fast_divide_by_10(const size_t power) const;
+	LongArith fast_divide_by_10(const size_t power, const RoundingMode mode = RoundingMode::TowardZero) const& {
+		LongArith result(*this);
+		result.fast_divide_by_10_inplace(power, mode);
+		return result;
+	}
+	LongArith fast_divide_by_10(const size_t power, const RoundingMode mode = RoundingMode::TowardZero)&& {
+		fast_divide_by_10_inplace(power, mode);
+		return std::move(*this);
+	}
+	LongArith& fast_divide_by_10_inplace(const size_t power, const RoundingMode mode = RoundingMode::TowardZero)&;
 
 	// \brief Divide value by 10^power
 	// \param power - exponent of 10
 	// \return value%10^power
 	LongArith fast_remainder_by_10(const size_t power) const;
 
+	// \brief Quotient (first) and remainder (second) of division by 10^power, remainder has sign of value
+	std::pair<LongArith, LongArith> fast_divmod_by_10(const size_t power) const& {
+		return LongArith(*this).fast_divmod_by_10(power);
+	}
+	std::pair<LongArith, LongArith> fast_divmod_by_10(const size_t power)&&;
+
+	// \brief Multiply value by 10^power
+	// \detailed Whole digits are inserted and the rest is shifted by one pass, complexity is O(len + power)
+	LongArith fast_multiply_by_10(const size_t power) const& {
+		LongArith result(*this);
+		result.fast_multiply_by_10_inplace(power);
+		return result;
+	}
+	LongArith fast_multiply_by_10(const size_t power)&& {
+		fast_multiply_by_10_inplace(power);
+		return std::move(*this);
+	}
+	LongArith& fast_multiply_by_10_inplace(const size_t power)&;
+
+	// \brief Rounds value to multiple of 10^power
+	LongArith round_to_10(const size_t power, const RoundingMode mode = RoundingMode::HalfEven) const& {
+		LongArith result(*this);
+		result.round_to_10_inplace(power, mode);
+		return result;
+	}
+	LongArith round_to_10(const size_t power, const RoundingMode mode = RoundingMode::HalfEven)&& {
+		round_to_10_inplace(power, mode);
+		return std::move(*this);
+	}
+	LongArith& round_to_10_inplace(const size_t power, const RoundingMode mode = RoundingMode::HalfEven)& {
+		return fast_divide_by_10_inplace(power, mode).fast_multiply_by_10_inplace(power);
+	}
+
+	// \brief Count of decimal digits of absolute value, complexity is O(1)
+	size_t decimal_digits() const noexcept;
+
+	// \brief Product computed by several threads
+	// \detailed Digits of shorter operand are split to blocks, every thread multiplies longer operand by own block.
+	//           Products with less than about million digit multiplications per thread are computed by one thread
+	static LongArith multiply(const LongArith& a, const LongArith& b, const ExecutionPolicy policy);
+
+	// \brief Product of range of LongArith values by balanced product tree
+	// \detailed Operands of every multiplication have close sizes, so work is close to work of last multiplication
+	//           instead of quadratic growth of loop of *=. Subtrees and big multiplications run in several threads
+	// \return 1 for empty range
+	template<typename Iter>
+	static LongArith product(Iter first, Iter last, const ExecutionPolicy policy = ExecutionPolicy::parallel()) {
+		const std::vector<const LongArith*> values = collect_values(first, last);
+		return product_of(values.data(), values.size(), policy);
+	}
+
+	// \brief Sum of range of LongArith values
+	// \detailed Every thread adds its part of range to 64-bit slots (one per digit position) without carry propagation,
+	//           carries are resolved once when parts are merged. Positive and negative values are summed separately
+	// \return 0 for empty range
+	template<typename Iter>
+	static LongArith sum(Iter first, Iter last, const ExecutionPolicy policy = ExecutionPolicy::parallel()) {
+		const std::vector<const LongArith*> values = collect_values(first, last);
+		return sum_of(values.data(), values.size(), policy);
+	}
+
+	// \brief Sum of products a[i] * b[i] for i in [0, a_last - a_first)
+	// \detailed Short products are added to slots of one LongAccumulator digit by digit without allocation and carries,
+	//           long ones are multiplied first. Parts of range are processed in several threads
+	template<typename IterA, typename IterB>
+	static LongArith dot(IterA a_first, IterA a_last, IterB b_first, const ExecutionPolicy policy = ExecutionPolicy::parallel()) {
+		const std::vector<const LongArith*> a = collect_values(a_first, a_last);
+		std::vector<const LongArith*> b;
+		b.reserve(a.size());
+		for (size_t i = 0; i < a.size(); ++i, ++b_first)
+			b.push_back(&*b_first);
+		return dot_of(a.data(), b.data(), a.size(), policy);
+	}
+
+	// \brief Remainders of |x| by many moduli: output[i] = |x| % moduli[i]
+	// \detailed Moduli are processed by blocks with own accumulator for every modulus, so digits of x are read
+	//           once per block and independent divisions of block overlap. Blocks run in several threads.
+	//           Throws std::logic_error if some modulus is zero
+	static void remainders(const LongArith& x, const std::uint64_t* moduli, const size_t count, std::uint64_t* output,
+		const ExecutionPolicy policy = ExecutionPolicy::parallel());
+	static std::vector<std::uint64_t> remainders(const LongArith& x, const std::vector<std::uint64_t>& moduli,
+		const ExecutionPolicy policy = ExecutionPolicy::parallel());
+
+	// \brief n! computed by product tree
+	static LongArith factorial(const unsigned long long n, const ExecutionPolicy policy = ExecutionPolicy::parallel());
+	// \brief Binomial coefficient C(n, k), 0 if k > n
+	// \detailed Computed as product of prime powers p^e <= n (Legendre formula) by product tree.
+	//           If k is much less than n, prime sieve is too expensive and n!/(k!(n-k)!) is computed by exact division
+	static LongArith binomial(const unsigned long long n, const unsigned long long k, const ExecutionPolicy policy = ExecutionPolicy::parallel());
+	// \brief Product of all primes which are not bigger than n
+	static LongArith primorial(const unsigned long long n, const ExecutionPolicy policy = ExecutionPolicy::parallel());
+
+	// \brief Low digits of product
+	// \detailed Computes only partial products which get into low nlimbs digits of DigitBase,
+	//           so it takes about half of work of full multiplication
+	// \return sign(a*b) * (|a*b| % DigitBase^nlimbs)
+	static LongArith mul_low(const LongArith& a, const LongArith& b, const size_t nlimbs);
+
+	// \brief High digits of product
+	// \detailed Skips partial products below the requested digits except two guard columns,
+	//           so it takes about half of work of full multiplication.
+	//           Lost carry from skipped part is less than one, so absolute value of result can be lower than exact value
+	//           of sign(a*b) * (|a*b| / DigitBase^(len(a)+len(b)-nlimbs)) by one unit of last digit at most.
+	//           len(x) is count of digits of DigitBase in x. Result is exact if nlimbs + 2 >= len(a) + len(b)
+	// \return Upper nlimbs digits of a*b
+	static LongArith mul_high(const LongArith& a, const LongArith& b, const size_t nlimbs);
+
+	//***************** BINARY FORMAT ***************
+	// Header byte: version in low 4 bits, 0x40 if digit count is varint, 0x80 if negative.
+	// Then digit count: 64-bit little-endian or LEB128 varint.
+	// Then digits from least significant, every digit is 32-bit little-endian value
+
+	static constexpr unsigned char BinaryFormatVersion = 1;
+
+	// \return count of bytes which serialize writes
+	size_t serialized_size(const bool varint_length = false) const noexcept;
+
+	// \brief Writes value in binary format
+	// \param out must have serialized_size(varint_length) bytes
+	// \return count of written bytes
+	size_t serialize(unsigned char* out, const bool varint_length = false) const;
+
+	// \brief Reads value in binary format
+	// \detailed Throws std::invalid_argument if data is broken
+	// \param consumed if not null, count of read bytes is written here
+	static LongArith deserialize(const unsigned char* data, const size_t size, size_t* consumed = nullptr);
+
+#if defined(LONGARITH_HAS_STD_BYTE)
+	size_t serialize(std::byte* out, const bool varint_length = false) const;
+	static LongArith deserialize(const std::byte* data, const size_t size, size_t* consumed = nullptr);
+#endif
+
+	// \brief Compares with serialized value without decoding it
+	// \return -1 if left < right, 0 if equal, 1 if left > right
+	static int compare(const LongArith& left, const LongArithView& right);
 
 	// \return true, if value can be stored in compute_t
 	inline bool plain_convertable()const {
@@ -119,6 +556,25 @@ public:
 	// \return value equal to this in plain version
 	compute_t to_plain_int()const;
 
+	// \brief Converts to nearest double (ties to even), values beyond double range become infinity
+	// \detailed Complexity is O(1): finite doubles cover not more than 35 digits, longer values are not read
+	double to_double()const noexcept;
+	// \brief Makes LongArith from integer part of value (rounds toward zero)
+	// \detailed Throws std::invalid_argument if value is infinity or NaN
+	static LongArith from_double(const double value);
+	// \brief Splits absolute value to mantissa in [0.5, 1) and binary exponent like std::frexp
+	// \detailed Works beyond double range, reads only most significant digits.
+	//              Mantissa is exact for values in double range, for bigger ones relative error is about digit count * 2^-53
+	// \return 0 for zero value
+	double frexp(long long& exponent)const noexcept;
+	// \brief Floor of decimal logarithm of absolute value, complexity is O(1)
+	// \detailed Throws std::logic_error for zero
+	size_t ilog10()const;
+	// \brief Natural and decimal logarithms computed from most significant digits, complexity is O(1)
+	// \detailed Throws std::logic_error for values not bigger than zero
+	double log()const;
+	double log10()const;
+
 	//***************** OPERATORS ***************
 
 
@@ -131,12 +587,14 @@ public:
 		return std::move(b += std::move(a));
 	}
 
-	friend LongArith operator+(LongArith a, const long b) {
-		return a += b;
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator+(LongArith a, const Int b) {
+		return std::move(a += b);
 	}
 
-	friend LongArith operator+(const long a, LongArith b) {
-		return b += a;
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator+(const Int a, LongArith b) {
+		return std::move(b += a);
 	}
 
 	// \brief Arithmetic substraction. Make copy of both arguments. Complexity is O(n)
@@ -150,19 +608,23 @@ public:
 		return std::move(left -= std::move(rigth));
 	}
 
-	friend LongArith operator-(LongArith left, const long rigth) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator-(LongArith left, const Int rigth) {
 		return std::move(left -= rigth);
 	}
 
-	friend LongArith operator-(const long left, LongArith rigth) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator-(const Int left, LongArith rigth) {
 		return -std::move(rigth -= left);
 	}
 
 	friend LongArith operator *(const LongArith& a, const LongArith& b);
-	friend LongArith operator *(LongArith a, const long b) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator *(LongArith a, const Int b) {
 		return std::move(a *= b);
 	}
-	friend LongArith operator *(const long a, LongArith b) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator *(const Int a, LongArith b) {
 		return std::move(b *= a);
 	}
 
@@ -170,11 +632,13 @@ public:
 		return LongArith::fraction_and_remainder(a, b).first;
 	}
 
-	friend LongArith operator /(const LongArith& a, const long b) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend LongArith operator /(const LongArith& a, const Int b) {
 		return LongArith::fraction_and_remainder(a, b).first;
 	}
 
-	friend long operator%(const LongArith& a, const long b) {
+	template<typename Int, typename = enable_if_native_t<Int>>
+	friend native_remainder_t<Int> operator%(const LongArith& a, const Int b) {
 		return LongArith::fraction_and_remainder(a, b).second;
 	}
 
@@ -198,11 +662,38 @@ public:
 
 	LongArith & operator+=(LongArith &&change)&;
 
-	LongArith & operator+=(long change)&;
+	template<typename Int, typename = enable_if_native_t<Int>>
+	LongArith & operator+=(const Int change)& {
+		add_native(native_negative(change), native_magnitude(change));
+		return *this;
+	}
 
 	// I created only prefix increment, because it faster and enough
 	LongArith & operator++()&;
 
+	// Serialized right operand. Addition and substraction read digits directly from view
+	LongArith & operator+=(const LongArithView &change)&;
+	LongArith & operator-=(const LongArithView &change)&;
+	LongArith & operator*=(const LongArithView &multiplier)&;
+	LongArith & operator/=(const LongArithView &divider)&;
+	LongArith & operator%=(const LongArithView &divider)&;
+
+	friend LongArith operator+(LongArith a, const LongArithView &b) {
+		return std::move(a += b);
+	}
+	friend LongArith operator-(LongArith a, const LongArithView &b) {
+		return std::move(a -= b);
+	}
+	friend LongArith operator*(LongArith a, const LongArithView &b) {
+		return std::move(a *= b);
+	}
+	friend LongArith operator/(LongArith a, const LongArithView &b) {
+		return std::move(a /= b);
+	}
+	friend LongArith operator%(LongArith a, const LongArithView &b) {
+		return std::move(a %= b);
+	}
+
 	LongArith & operator-=(const LongArith &change)& {
 		return *this += -change;
 	}
@@ -213,21 +704,26 @@ public:
 
 	// I created only prefix decrement, because it faster and enough
 	LongArith & operator--()&;
-	LongArith & operator-=(long change)&;
 
-	LongArith & operator*=(const LongArith& multiplier)& {
-		return (*this = (*this)*multiplier);
+	template<typename Int, typename = enable_if_native_t<Int>>
+	LongArith & operator-=(const Int change)& {
+		add_native(!native_negative(change), native_magnitude(change));
+		return *this;
 	}
 
-	LongArith & operator*=(long multiplier)&;
+	// Multiplies in place if multiplier has one digit
+	LongArith & operator*=(const LongArith& multiplier)&;
 
-	LongArith & operator/=(const LongArith& divider)& {
-		return (*this = LongArith::fraction_and_remainder(*this, divider).first);
+	template<typename Int, typename = enable_if_native_t<Int>>
+	LongArith & operator*=(const Int multiplier)& {
+		mult_native(native_negative(multiplier), native_magnitude(multiplier));
+		return *this;
 	}
 
-	LongArith & operator%=(const LongArith& divider)& {
-		return (*this = LongArith::fraction_and_remainder(*this, divider).second);
-	}
+	// Work in place by divmod
+	LongArith & operator/=(const LongArith& divider)&;
+
+	LongArith & operator%=(const LongArith& divider)&;
 
 	//Compare
 	friend bool operator<(const LongArith& left, const LongArith &right);
@@ -250,8 +746,13 @@ public:
 
 	LongArith &operator=(LongArith &&temp)& = default;
 
+	// Writes digits by blocks directly to stream buffer, full decimal string is never built.
+	// Width, fill and adjustment of stream are supported
 	friend std::ostream &operator<<(std::ostream &os, const LongArith &obj);
 
+	// Reads sign and digits directly from stream buffer and parses them by groups of DigitStringLength characters,
+	// full decimal string is never built. Stops at first character that is not a digit.
+	// Sets failbit and zero value if there are no digits
 	friend std::istream &operator >> (std::istream &is, LongArith& obj);
 
 protected:
@@ -331,6 +832,319 @@ private:
 	container_type storage;
 };
 
+// Non-owning read-only view of value in binary format of LongArith::serialize.
+// Digits are read directly from buffer, so it can point to memory mapped file. Buffer must outlive view.
+// Construction checks header and size of buffer in O(1), digits are not checked.
+class LongArithView
+{
+public:
+	typedef LongArith::digit_t digit_t;
+
+	// Throws std::invalid_argument if header is broken or buffer is too short
+	LongArithView(const unsigned char* data, const size_t size);
+#if defined(LONGARITH_HAS_STD_BYTE)
+	LongArithView(const std::byte* data, const size_t size)
+		: LongArithView(reinterpret_cast<const unsigned char*>(data), size) {}
+#endif
+
+	// count of digits of DigitBase
+	inline size_t size() const noexcept {
+		return digit_count;
+	}
+	// digit of DigitBase, least significant first
+	digit_t operator[](const size_t index) const noexcept;
+	inline bool negative() const noexcept {
+		return is_negative;
+	}
+	bool equals_zero() const noexcept;
+	// count of bytes of serialized value
+	inline size_t serialized_size() const noexcept {
+		return byte_size;
+	}
+
+	LongArith to_LongArith() const;
+
+	friend bool operator==(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) == 0;
+	}
+	friend bool operator!=(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) != 0;
+	}
+	friend bool operator<(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) < 0;
+	}
+	friend bool operator<=(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) <= 0;
+	}
+	friend bool operator>(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) > 0;
+	}
+	friend bool operator>=(const LongArith& left, const LongArithView& right) {
+		return LongArith::compare(left, right) >= 0;
+	}
+	friend bool operator==(const LongArithView& left, const LongArith& right) {
+		return right == left;
+	}
+	friend bool operator!=(const LongArithView& left, const LongArith& right) {
+		return right != left;
+	}
+	friend bool operator<(const LongArithView& left, const LongArith& right) {
+		return right > left;
+	}
+	friend bool operator<=(const LongArithView& left, const LongArith& right) {
+		return right >= left;
+	}
+	friend bool operator>(const LongArithView& left, const LongArith& right) {
+		return right < left;
+	}
+	friend bool operator>=(const LongArithView& left, const LongArith& right) {
+		return right <= left;
+	}
+
+private:
+	const unsigned char* digits;
+	size_t digit_count;
+	size_t byte_size;
+	bool is_negative;
+};
+
+// Accumulator for long sequences of additions of short values.
+// Keeps sums of digits of every position in 64-bit slots (positive and negative values separately).
+// Carries are resolved only when value is read or slot could overflow, so adding value costs adding its digits to slots.
+class LongAccumulator
+{
+public:
+	LongAccumulator() noexcept;
+	explicit LongAccumulator(const LongArith& initial);
+
+	LongAccumulator& operator+=(const LongArith& value);
+	LongAccumulator& operator-=(const LongArith& value);
+	LongAccumulator& operator+=(const LongAccumulator& other);
+	// \brief Adds a*b
+	// \detailed Products of short values go to slots digit by digit without temporary LongArith
+	LongAccumulator& add_product(const LongArith& a, const LongArith& b);
+
+	template<typename Int, typename = LongArith::enable_if_native_t<Int>>
+	LongAccumulator& operator+=(const Int value) {
+		add_native(LongArith::native_negative(value), LongArith::native_magnitude(value));
+		return *this;
+	}
+	template<typename Int, typename = LongArith::enable_if_native_t<Int>>
+	LongAccumulator& operator-=(const Int value) {
+		add_native(!LongArith::native_negative(value), LongArith::native_magnitude(value));
+		return *this;
+	}
+
+	// \brief Accumulated value, complexity is O(n)
+	LongArith to_LongArith() const;
+	// Resets value to zero, keeps memory
+	void clear() noexcept;
+
+private:
+	void add(const bool negative_value, const LongArith::digit_t* digits, const size_t size);
+	void add_native(const bool negative_value, const LongArith::native_uint_t magnitude);
+	// Resolves carries in all slots
+	void normalize();
+
+	std::vector<std::uint64_t> positive;
+	std::vector<std::uint64_t> negative;
+	// Additions since last normalization
+	size_t pending;
+};
+
+// Counter which is updated by many threads concurrently.
+// Every thread works with one of shards: its native 64-bit delta is changed by one atomic addition
+// and is moved to LongArith of shard under lock only when it becomes too big. load() merges shards.
+class ConcurrentLongCounter
+{
+public:
+	// \param shards - count of shards, 0 means count of hardware threads
+	explicit ConcurrentLongCounter(const size_t shards = 0);
+	~ConcurrentLongCounter();
+	ConcurrentLongCounter(const ConcurrentLongCounter&) = delete;
+	ConcurrentLongCounter& operator=(const ConcurrentLongCounter&) = delete;
+
+	// \brief Adds delta to shard of calling thread
+	// \detailed Wait-free if |delta| < 2^40, except rare moves of big delta of shard to its LongArith
+	void add(const long long delta);
+	// \brief Adds delta to shard of calling thread under lock of shard
+	void add(const LongArith& delta);
+	// \brief Sum of all shards
+	// \detailed Every finished update is included, updates which run concurrently with load may be not included
+	LongArith load() const;
+
+private:
+	struct shard;
+	// Raw memory of shards, shards start at first aligned address in it
+	void* shard_memory;
+	shard* shards;
+	size_t shard_count;
+};
+
+// Batch container of LongArith values.
+// Digits of all values are stored in one contiguous arena, offsets and signs are kept in side arrays,
+// so scanning of many values reads memory sequentially. Elements are read through lightweight views.
+// Batch operations build new arena by one pass.
+class LongArithVector
+{
+public:
+	typedef LongArith::digit_t digit_t;
+
+	// Read-only view of element, valid until vector is changed
+	class ElementView
+	{
+	public:
+		// count of digits of DigitBase
+		inline size_t size() const noexcept {
+			return digit_count;
+		}
+		// digit of DigitBase, least significant first
+		inline digit_t operator[](const size_t index) const noexcept {
+			return digits[index];
+		}
+		inline bool negative() const noexcept {
+			return is_negative;
+		}
+		inline bool equals_zero() const noexcept {
+			return digit_count == 1 && !digits[0];
+		}
+		LongArith to_LongArith() const;
+	private:
+		friend class LongArithVector;
+		ElementView(const digit_t* element_digits, const size_t count, const bool element_negative) noexcept
+			: digits(element_digits), digit_count(count), is_negative(element_negative) {}
+		const digit_t* digits;
+		size_t digit_count;
+		bool is_negative;
+	};
+
+	LongArithVector();
+
+	template<typename Iter>
+	LongArithVector(Iter first, Iter last) : LongArithVector() {
+		append(first, last);
+	}
+
+	inline size_t size() const noexcept {
+		return negative.size();
+	}
+	inline bool empty() const noexcept {
+		return negative.empty();
+	}
+	// count of digits of all values
+	inline size_t digit_count() const noexcept {
+		return digits.size();
+	}
+	void reserve(const size_t values, const size_t total_digits);
+	void clear();
+
+	inline ElementView operator[](const size_t index) const noexcept {
+		return ElementView(digits.data() + offsets[index], offsets[index + 1] - offsets[index], negative[index] != 0);
+	}
+
+	void push_back(const LongArith& value);
+
+	// \brief Appends range of LongArith values, memory is reserved once for forward iterators
+	template<typename Iter>
+	void append(Iter first, Iter last) {
+		if (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iter>::iterator_category>::value)
+		{
+			size_t values = 0, total_digits = 0;
+			for (Iter it = first; it != last; ++it, ++values)
+				total_digits += digits_of(*it);
+			reserve(size() + values, digit_count() + total_digits);
+		}
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	// \brief this[i] += other[i] for every i
+	// \detailed Throws std::invalid_argument if vectors have different sizes
+	void add(const LongArithVector& other);
+	// \brief this[i] *= multiplier for every i
+	void multiply(const long long multiplier);
+	// \return -1 if this[left] < this[right], 0 if equal, 1 if this[left] > this[right]
+	int compare(const size_t left, const size_t right) const noexcept;
+	// \brief Sorts values ascending, arena is rebuilt in sorted order
+	void sort();
+
+private:
+	friend class LongArith;
+
+	// count of digits of DigitBase in value
+	static size_t digits_of(const LongArith& value) noexcept;
+	// LongArith with copy of digits
+	static LongArith make_value(const digit_t* value_digits, const size_t count, const bool value_negative);
+
+	std::vector<digit_t> digits;
+	// Element i has digits [offsets[i], offsets[i + 1])
+	std::vector<size_t> offsets;
+	std::vector<unsigned char> negative;
+};
+
+// Value in residue number system: residues modulo fixed primes below 2^31, one prime per channel.
+// Addition, substraction and multiplication work in every channel independently without carries,
+// value is restored by Chinese remainder theorem only in to_LongArith.
+// Value is kept modulo product M of primes of channels and restored in range (-M/2, M/2],
+// so results are exact while all intermediate values fit in this range (see channels_for).
+class RnsLongArith
+{
+public:
+	typedef LongArith::ExecutionPolicy ExecutionPolicy;
+
+	static constexpr size_t MaxChannels = 16384;
+
+	// \brief Count of channels enough for values with at most decimal_digits decimal digits
+	// \detailed Throws std::invalid_argument if more than MaxChannels are needed
+	static size_t channels_for(const size_t decimal_digits);
+
+	// \brief Zero in given count of channels
+	// \detailed Throws std::invalid_argument if channels is 0 or greater than MaxChannels
+	explicit RnsLongArith(const size_t channels = 1);
+
+	// \brief Residues of value, computed by LongArith::remainders
+	static RnsLongArith from(const LongArith& value, const size_t channels,
+		const ExecutionPolicy policy = ExecutionPolicy::sequential());
+	// \brief Restores value by Garner algorithm. O(channels^2)
+	LongArith to_LongArith() const;
+
+	inline size_t channels() const noexcept {
+		return residues.size();
+	}
+
+	// \brief Channel-wise operations, channels are shared between threads
+	// \detailed Throws std::invalid_argument if operands have different count of channels
+	static RnsLongArith add(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy);
+	static RnsLongArith substract(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy);
+	static RnsLongArith multiply(const RnsLongArith& a, const RnsLongArith& b, const ExecutionPolicy policy);
+
+	RnsLongArith& operator+=(const RnsLongArith& other);
+	RnsLongArith& operator-=(const RnsLongArith& other);
+	RnsLongArith& operator*=(const RnsLongArith& other);
+	RnsLongArith operator-() const;
+
+	friend RnsLongArith operator+(RnsLongArith a, const RnsLongArith& b) {
+		return std::move(a += b);
+	}
+	friend RnsLongArith operator-(RnsLongArith a, const RnsLongArith& b) {
+		return std::move(a -= b);
+	}
+	friend RnsLongArith operator*(RnsLongArith a, const RnsLongArith& b) {
+		return std::move(a *= b);
+	}
+
+	friend bool operator==(const RnsLongArith& a, const RnsLongArith& b) {
+		return a.residues == b.residues;
+	}
+	friend bool operator!=(const RnsLongArith& a, const RnsLongArith& b) {
+		return !(a == b);
+	}
+
+private:
+	// residues[i] < prime of channel i
+	std::vector<std::uint32_t> residues;
+};
+
 namespace std {
 	template<>
 	inline void swap<LongArith>(LongArith& a, LongArith& b) noexcept {
@@ -0,0 +1,147 @@
+// Regression test of long division (fraction_and_remainder, divmod, / and %).
+// Build it together with LongArith.cpp, e.g. g++ -std=c++14 -I.. division_test.cpp ../LongArith.cpp -pthread
+// Returns 0 if all checks pass and prints failed cases otherwise.
+#include "LongArith.h"
+#include <iostream>
+#include <random>
+#include <string>
+
+static std::mt19937_64 generator(20261019);
+static size_t failures = 0;
+
+static void check(const bool condition, const std::string& what, const LongArith& dividable, const LongArith& divider)
+{
+	if (condition)
+		return;
+	++failures;
+	std::cerr << "FAILED " << what << ": " << dividable << " / " << divider << std::endl;
+}
+
+// Random decimal string of given length. Mostly_nines makes long runs of 9 and 0,
+// which give estimates of fraction digits at edges of their range
+static std::string random_number(const size_t length, const bool mostly_nines)
+{
+	std::string s;
+	if (generator() % 2)
+		s += '-';
+	s += static_cast<char>('1' + generator() % 9);
+	for (size_t i = 1; i < length; ++i)
+	{
+		if (mostly_nines)
+			s += (generator() % 4) ? '9' : ((generator() % 3) ? '0' : static_cast<char>('0' + generator() % 10));
+		else
+			s += static_cast<char>('0' + generator() % 10);
+	}
+	return s;
+}
+
+static LongArith absolute(const LongArith& value)
+{
+	return value.sign() < 0 ? -value : value;
+}
+
+// Truncated division is the only pair with dividable == fraction*divider + remainder,
+// |remainder| < |divider| and remainder with sign of dividable, so these checks define result completely
+static void check_division(const LongArith& dividable, const LongArith& divider)
+{
+	const auto result = LongArith::fraction_and_remainder(dividable, divider);
+	const LongArith& fraction = result.first;
+	const LongArith& remainder = result.second;
+	check(fraction * divider + remainder == dividable, "fraction*divider + remainder == dividable", dividable, divider);
+	check(absolute(remainder) < absolute(divider), "|remainder| < |divider|", dividable, divider);
+	check(remainder.equals_zero() || remainder.sign() == dividable.sign(), "sign of remainder", dividable, divider);
+	check(dividable / divider == fraction && dividable % divider == remainder, "operators / and %", dividable, divider);
+
+	// Outputs which are same objects as arguments
+	LongArith a = dividable, b = divider;
+	LongArith::divmod(a, b, a, b);
+	check(a == fraction && b == remainder, "divmod(a, b, a, b)", dividable, divider);
+	a = dividable;
+	b = divider;
+	LongArith::divmod(a, b, b, a);
+	check(b == fraction && a == remainder, "divmod(a, b, b, a)", dividable, divider);
+	a = dividable;
+	a /= divider;
+	check(a == fraction, "/=", dividable, divider);
+	a = dividable;
+	a %= divider;
+	check(a == remainder, "%=", dividable, divider);
+}
+
+int main()
+{
+	// Known results
+	const LongArith nines36 = LongArith::from_string("999999999999999999999999999999999999");
+	const LongArith nines18 = LongArith::from_string("999999999999999999");
+	check(nines36 / nines18 == LongArith::from_string("1000000000000000001"), "(10^36-1)/(10^18-1)", nines36, nines18);
+	check((nines36 % nines18).equals_zero(), "(10^36-1)%(10^18-1)", nines36, nines18);
+	const LongArith power = LongArith::from_string("1000000000000000000000000000");
+	const LongArith divider = LongArith::from_string("1000000001");
+	check(power / divider == LongArith::from_string("999999999000000000"), "10^27/(10^9+1)", power, divider);
+	check(power % divider == LongArith(1000000000), "10^27%(10^9+1)", power, divider);
+	check(LongArith(-7) / LongArith(2) == LongArith(-3) && LongArith(-7) % LongArith(2) == LongArith(-1), "-7/2", LongArith(-7), LongArith(2));
+
+	// Random operands of close and different lengths
+	for (int i = 0; i < 3000; ++i)
+	{
+		const bool mostly_nines = i % 3 == 0;
+		const size_t divider_length = 1 + generator() % 200;
+		const long long length_difference = static_cast<long long>(generator() % 300) - 20;
+		const size_t dividable_length = static_cast<size_t>(std::max<long long>(1, static_cast<long long>(divider_length) + length_difference));
+		check_division(LongArith::from_string(random_number(dividable_length, mostly_nines)),
+			LongArith::from_string(random_number(divider_length, mostly_nines)));
+	}
+
+	// Divider with top digit 1 and zeros after it and dividend with maximal digits
+	for (size_t digits = 2; digits < 12; ++digits)
+	{
+		const LongArith small_top = LongArith::from_string("1" + std::string(digits * 9 - 1, '0') + "1");
+		const LongArith big = LongArith::from_string(std::string(digits * 18, '9'));
+		check_division(big, small_top);
+		check_division(big, small_top - 2);
+		check_division(big - 1, big / 3);
+	}
+
+	// Dividend is built from known fraction and remainder. Digits of DigitBase are mostly 0 or DigitBase-1
+	// and remainder is close to divider, so estimates of fraction digits are at edges of their range
+	for (int i = 0; i < 3000; ++i)
+	{
+		std::string divider_digits, fraction_digits;
+		const size_t divider_length = 1 + generator() % 12, fraction_length = 1 + generator() % 12;
+		for (size_t k = 0; k < divider_length; ++k)
+		{
+			const unsigned kind = generator() % 4;
+			const unsigned long long digit = kind == 0 ? 999999999ULL : (kind == 1 ? 0 : (kind == 2 ? 1 + generator() % 9 : generator() % 1000000000ULL));
+			const std::string text = std::to_string(digit);
+			divider_digits += std::string(9 - text.size(), '0') + text;
+		}
+		for (size_t k = 0; k < fraction_length; ++k)
+			fraction_digits += (generator() % 3) ? "999999999" : "000000000";
+		const LongArith divider = LongArith::from_string("1" + divider_digits);
+		const LongArith fraction = LongArith::from_string("1" + fraction_digits);
+		const LongArith remainder = divider - 1 - static_cast<long long>(generator() % 3);
+		const LongArith dividable = fraction * divider + remainder;
+		const auto result = LongArith::fraction_and_remainder(dividable, divider);
+		check(result.first == fraction && result.second == remainder, "known fraction and remainder", dividable, divider);
+		check_division(-dividable, divider);
+	}
+
+	// Long divider gives same result as plain one
+	for (int i = 0; i < 1000; ++i)
+	{
+		const LongArith dividable = LongArith::from_string(random_number(1 + generator() % 100, i % 2 == 0));
+		const long long plain = static_cast<long long>(generator() % 1000000000000000000ULL) + 1;
+		const auto plain_result = LongArith::fraction_and_remainder(dividable, plain);
+		const auto long_result = LongArith::fraction_and_remainder(dividable, LongArith(plain));
+		check(plain_result.first == long_result.first && LongArith(plain_result.second) == long_result.second,
+			"plain and long divider", dividable, LongArith(plain));
+	}
+
+	if (failures)
+	{
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All division checks passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Regression test of long multiplication (schoolbook, Karatsuba and chunked unbalanced products).
+// Build it together with LongArith.cpp, e.g. g++ -std=c++14 -I.. multiplication_test.cpp ../LongArith.cpp -pthread
+// Returns 0 if all checks pass and prints failed cases otherwise.
+#include "LongArith.h"
+#include <iostream>
+#include <random>
+#include <string>
+
+static std::mt19937_64 generator(20261019);
+static size_t failures = 0;
+
+static void check(const bool condition, const std::string& what, const LongArith& a, const LongArith& b)
+{
+	if (condition)
+		return;
+	++failures;
+	std::cerr << "FAILED " << what << ": " << a << " * " << b << std::endl;
+}
+
+// Random decimal string of given length. Mostly_nines makes long runs of 9 and 0,
+// which give longest carries in sums and differences of halves
+static std::string random_number(const size_t length, const bool mostly_nines)
+{
+	std::string s;
+	if (generator() % 2)
+		s += '-';
+	s += static_cast<char>('1' + generator() % 9);
+	for (size_t i = 1; i < length; ++i)
+	{
+		if (mostly_nines)
+			s += (generator() % 4) ? '9' : ((generator() % 3) ? '0' : static_cast<char>('0' + generator() % 10));
+		else
+			s += static_cast<char>('0' + generator() % 10);
+	}
+	return s;
+}
+
+// Product by multiplications to plain numbers of 9 decimal digits, it doesn't use long multiplication
+static LongArith reference_product(const LongArith& a, const LongArith& b)
+{
+	std::string digits = b.to_string();
+	const bool negative = digits[0] == '-';
+	if (negative)
+		digits.erase(0, 1);
+	LongArith result;
+	size_t shift = 0;
+	for (size_t end = digits.size(); end > 0; end -= std::min<size_t>(end, 9), shift += 9)
+	{
+		const size_t begin = end - std::min<size_t>(end, 9);
+		LongArith row = a;
+		row *= std::stoll(digits.substr(begin, end - begin));
+		row.fast_multiply_by_10_inplace(shift);
+		result += row;
+	}
+	return negative ? -result : result;
+}
+
+static void check_product(const LongArith& a, const LongArith& b)
+{
+	const LongArith product = a * b;
+	check(product == reference_product(a, b), "a*b", a, b);
+	check(b * a == product, "b*a", a, b);
+	LongArith c = a;
+	c *= b;
+	check(c == product, "*=", a, b);
+	check(LongArith::multiply(a, b, LongArith::ExecutionPolicy::parallel(4)) == product, "parallel multiply", a, b);
+}
+
+int main()
+{
+	// Known results
+	const LongArith nines = LongArith::from_string(std::string(1000, '9'));
+	check(nines * nines == LongArith::from_string(std::string(999, '9') + '8' + std::string(999, '0') + '1'), "(10^1000-1)^2", nines, nines);
+	const LongArith power = LongArith::from_string('1' + std::string(900, '0'));
+	check(power * power == LongArith::from_string('1' + std::string(1800, '0')), "10^900*10^900", power, power);
+
+	// Operands of close sizes go to Karatsuba, very different ones are multiplied by chunks
+	for (int i = 0; i < 600; ++i)
+	{
+		const bool mostly_nines = i % 3 == 0;
+		const size_t a_length = 1 + generator() % 4000;
+		const size_t close_length = a_length - std::min<size_t>(a_length - 1, generator() % 20);
+		const size_t b_length = (i % 2) ? 1 + generator() % 4000 : close_length;
+		check_product(LongArith::from_string(random_number(a_length, mostly_nines)),
+			LongArith::from_string(random_number(b_length, mostly_nines)));
+	}
+
+	// Squares, where sums of halves are equal
+	for (int i = 0; i < 100; ++i)
+	{
+		const LongArith a = LongArith::from_string(random_number(1 + generator() % 4000, i % 2 == 0));
+		check_product(a, a);
+	}
+
+	if (failures)
+	{
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All multiplication checks passed" << std::endl;
+	return 0;
+}
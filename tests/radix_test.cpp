@@ -0,0 +1,105 @@
+// Regression test of radix conversion (to_string_radix and from_string_radix).
+// Build it together with LongArith.cpp, e.g. g++ -std=c++14 -I.. radix_test.cpp ../LongArith.cpp -pthread
+// Returns 0 if all checks pass and prints failed cases otherwise.
+#include "LongArith.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+static std::mt19937_64 generator(20261019);
+static size_t failures = 0;
+static const char Symbols[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static void check(const bool condition, const std::string& what, const unsigned radix, const std::string& symbols)
+{
+	if (condition)
+		return;
+	++failures;
+	std::cerr << "FAILED " << what << " in radix " << radix << ": " << symbols.substr(0, 100) << std::endl;
+}
+
+// Random symbols of given length without leading zero. Mostly_max makes long runs of biggest symbol and zero,
+// which give remainders close to powers of radix
+static std::string random_symbols(const size_t length, const unsigned radix, const bool mostly_max)
+{
+	std::string s(1, Symbols[1 + generator() % (radix - 1)]);
+	for (size_t i = 1; i < length; ++i)
+	{
+		if (mostly_max)
+			s += (generator() % 4) ? Symbols[radix - 1] : '0';
+		else
+			s += Symbols[generator() % radix];
+	}
+	return s;
+}
+
+// Symbols by repeated division by plain power of radix, it doesn't use cached powers
+static std::string reference_symbols(LongArith value, const unsigned radix)
+{
+	long long chunk_base = radix;
+	size_t chars_per_chunk = 1;
+	while (chunk_base <= 1000000000000000LL / radix)
+	{
+		chunk_base *= radix;
+		++chars_per_chunk;
+	}
+	const bool negative = value.sign() < 0;
+	if (negative)
+		value = -value;
+	std::string s;
+	do
+	{
+		const auto result = LongArith::fraction_and_remainder(value, chunk_base);
+		long long chunk = result.second;
+		value = result.first;
+		for (size_t i = 0; i < chars_per_chunk; ++i)
+		{
+			s += Symbols[chunk % radix];
+			chunk /= radix;
+		}
+	} while (!value.equals_zero());
+	while (s.size() > 1 && s.back() == '0')
+		s.pop_back();
+	if (negative)
+		s += '-';
+	std::reverse(s.begin(), s.end());
+	return s;
+}
+
+static void check_round_trip(const std::string& symbols, const unsigned radix)
+{
+	const LongArith value = LongArith::from_string_radix(symbols, radix);
+	check(value.to_string_radix(radix) == symbols, "round trip", radix, symbols);
+	check(reference_symbols(value, radix) == symbols, "from_string_radix", radix, symbols);
+}
+
+int main()
+{
+	// Known results
+	check(LongArith(255).to_string_radix(16) == "ff", "255", 16, "ff");
+	check(LongArith(-35).to_string_radix(36) == "-z", "-35", 36, "-z");
+	check(LongArith(0).to_string_radix(2) == "0", "0", 2, "0");
+	check(LongArith::from_string_radix(" \t-FF", 16) == LongArith(-255), "-FF", 16, " \t-FF");
+	const std::string power = "1" + std::string(5000, '0');
+	check(LongArith::from_string_radix(power, 2) == LongArith::from_string_radix(power.substr(0, 1251), 16), "2^5000", 2, power);
+
+	// Short and long values, long ones are divided by Newton reciprocals of cached powers
+	for (int i = 0; i < 300; ++i)
+	{
+		const unsigned radix = 2 + static_cast<unsigned>(generator() % 35);
+		const size_t length = 1 + generator() % ((i % 10) ? 3000 : 30000);
+		std::string symbols = random_symbols(length, radix, i % 3 == 0);
+		if (generator() % 2)
+			symbols.insert(0, 1, '-');
+		check_round_trip(symbols, radix);
+	}
+
+	if (failures)
+	{
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "All radix checks passed" << std::endl;
+	return 0;
+}